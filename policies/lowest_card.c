@@ -0,0 +1,67 @@
+#include "taki_policy.h"
+
+// An example policy plugin: drops the special cards first, then the lowest card code, and chooses the color it has most cards of.
+// Build: gcc -shared -fPIC -I src -o exe/lowest_card.so policies/lowest_card.c
+
+/*
+ * Choose the card to drop: a special card if there is one, or else the lowest card code that can be dropped.
+ * Receives the policy's state (unused) and the view of the game.
+ * Returns the card code, or TAKI_NO_CARD to draw a card.
+ */
+static int Choose_Card(void* state, const TAKI_POLICY_VIEW* view)
+{
+    uint64_t specials = view->legal_plays & (~0ULL << TAKI_FIRST_SPECIAL_CODE); // The special cards that can be dropped.
+
+    (void) state;
+
+    if (view->legal_plays == 0)
+        return TAKI_NO_CARD;
+
+    return __builtin_ctzll(specials != 0 ? specials : view->legal_plays);
+}
+
+
+/*
+ * Choose the color of a COLOR card: the color the player has most normal cards of.
+ * Receives the policy's state (unused) and the view of the game.
+ * Returns the color (1-4).
+ */
+static int Choose_Color(void* state, const TAKI_POLICY_VIEW* view)
+{
+    int best_color = 1, best_count = -1; // The chosen color and how many cards of it the player has.
+
+    (void) state;
+
+    for (int color = 1; color <= 4; color++)
+    {
+        int count = 0; // The number of normal cards of the color.
+
+        for (int number = 0; number < 9; number++)
+            count += view->hand_counts[(color - 1) * 9 + number];
+        if (count > best_count)
+        {
+            best_color = color;
+            best_count = count;
+        }
+    }
+
+    return best_color;
+}
+
+
+static const TAKI_POLICY LOWEST_CARD_POLICY = {
+    .abi_version = TAKI_POLICY_ABI_VERSION,
+    .name = "lowest card",
+    .choose_card = Choose_Card,
+    .choose_color = Choose_Color,
+};
+
+
+/*
+ * The function the game looks for when it loads the plugin.
+ * Returns the policy's table.
+ */
+const TAKI_POLICY* Taki_Get_Policy(void)
+{
+    return &LOWEST_CARD_POLICY;
+}
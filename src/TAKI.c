@@ -1,17 +1,33 @@
 #include "header.h"
 
-int main()
+int main(int argc, char* argv[])
 {
     GAME_DATA game_data; // Game settings.
+    uint64_t seed; // The seed of the game's random numbers.
+    TUI tui; // The full screen mode.
+    bool is_tui_on = false; // True if the game is played in the full screen mode.
+    AI_PLAYER ai; // The computer's players.
+    bool is_ai_on = false; // True if the computer plays one of the players.
 
-    // Generate a random seed for the random functions, using the computer's internal clock.
-    srand(time(NULL)); 
+    // Full screen mode: TAKI tui [seed]. Shows the cards in their colors, and redraws only what changed on the screen.
+    if (argc > 1 && !strcmp(argv[1], "tui"))
+    {
+        is_tui_on = true;
+        argc--; // The seed is after the mode.
+        argv++;
+    }
+
+    // Use the seed given in the command line to replay a game, otherwise generate a random seed using the computer's internal clock.
+    if (argc > 1)
+        seed = strtoull(argv[1], NULL, 10);
+    else
+        seed = (uint64_t) time(NULL);
 
     // Print welcome message.
     Print_Welcome_Screen();
 
-    // Initialize the game's data.
-    Init_Game_Data(&game_data);
+    // Initialize the game's data, and shuffle the standard deck.
+    Init_Game_Data(&game_data, seed, 0, STANDARD_DECK_COUNTS);
 
     // Set the number of players in the game.
     Set_Nof_Players(&game_data.nof_players);
@@ -28,14 +44,30 @@ int main()
     // Give every player in the game his start cards (NOF_START_CARDS = 4).
     Hand_Start_Cards(&game_data, game_data.players, game_data.nof_players);
 
+    // Start the computer's search threads if the computer plays one of the players.
+    for (int player_i = 0; player_i < game_data.nof_players; player_i++)
+        is_ai_on = is_ai_on || game_data.players[player_i].is_computer;
+    if (is_ai_on)
+        Ai_Init(&ai, 0, AI_MOVE_SECONDS, seed);
+
     // Start playing the game.
-    Play_Game(&game_data);
+    if (is_tui_on)
+    {
+        Tui_Init(&tui);
+        Play_Game(&game_data, &tui, is_ai_on ? &ai : NULL);
+        Tui_Free(&tui);
+    }
+    else
+        Play_Game(&game_data, NULL, is_ai_on ? &ai : NULL);
+
+    if (is_ai_on)
+        Ai_Free(&ai);
 
-    // Sort the game's statistics.
-    Sort_Stats_Array(&game_data);
+    // Print the game's statistics, sorted by the frequency of the cards.
+    Print_Game_Stats(&game_data);
 
-    // Print the game's statistics.
-    Print_Game_Stats(game_data);
+    // Print the seed, running the game again with it deals the same cards.
+    printf("\nGame seed: %llu\n", (unsigned long long) game_data.seed);
 
     // Free the memory allocated by malloc function for the cards arrays for all the players.
     Free_Cards_Arrays(game_data.players, game_data.nof_players);
@@ -0,0 +1,482 @@
+#include "header.h"
+
+// -------------------- AI Functions ---------------------
+// A computer player using Information Set Monte Carlo Tree Search.
+// The player can't see the other players' hands and the order of the draw pile, so every rollout first guesses them:
+// the cards the player didn't see are shuffled and dealt to the other players, and the rest become the draw pile.
+// All the guesses share one tree of moves. A move that isn't legal in a guess is skipped, and counts how many times every move was legal,
+// so moves that are rarely possible are compared fairly.
+// Every worker thread grows its own tree for the same time, and the moves of the trees' roots are added together at the end.
+// The threads wait between the moves, so a move doesn't pay for creating them.
+
+/*
+ * Start a computer player and its worker threads.
+ * Receives a pointer to the AI, the number of threads (0 to use all the cores), how long every move is searched and the seed of the AI's random numbers.
+ * If the allocation failed, prints error message and ends the program.
+ */
+void Ai_Init(AI_PLAYER* ai_p, int nof_threads, double seconds_per_move, uint64_t seed)
+{
+    // Use all the cores of the computer if the number of threads wasn't set.
+    if (nof_threads <= 0)
+        nof_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (nof_threads <= 0)
+        nof_threads = 1;
+
+    // Try to allocate the workers, aligned to the cache lines so the workers don't share them, and the searched game.
+    ai_p->workers = (AI_WORKER*) aligned_alloc(CACHE_LINE_SIZE, sizeof(AI_WORKER) * nof_threads);
+    ai_p->root_game_p = (GAME_SNAPSHOT*) malloc(Game_Snapshot_Size(MAX_SIM_PLAYERS));
+
+    // Check if the allocation failed.
+    if (ai_p->workers == NULL || ai_p->root_game_p == NULL)
+    {
+        printf("Memory allocation failed!!!\n");
+        exit(1); // Stop the program.
+    }
+
+    ai_p->nof_workers = nof_threads;
+    ai_p->seconds_per_move = seconds_per_move;
+    ai_p->search_i = 0;
+    ai_p->nof_busy = 0;
+    ai_p->is_stopping = false;
+    pthread_mutex_init(&ai_p->mutex, NULL);
+    pthread_cond_init(&ai_p->start_cond, NULL);
+    pthread_cond_init(&ai_p->done_cond, NULL);
+
+    for (int worker_i = 0; worker_i < nof_threads; worker_i++)
+    {
+        AI_WORKER* worker_p = &ai_p->workers[worker_i]; // The worker being started.
+
+        Arena_Init(&worker_p->arena, AI_ARENA_CHUNK_SIZE);
+        Rng_Seed(&worker_p->rng, seed, (uint64_t) worker_i); // Every worker guesses different cards.
+        worker_p->game_p = (GAME_SNAPSHOT*) malloc(Game_Snapshot_Size(MAX_SIM_PLAYERS));
+        worker_p->root_p = NULL;
+        worker_p->nof_rollouts = 0;
+        worker_p->ai_p = ai_p;
+
+        // Check if the allocation failed.
+        if (worker_p->game_p == NULL)
+        {
+            printf("Memory allocation failed!!!\n");
+            exit(1); // Stop the program.
+        }
+
+        // The first worker runs on the thread that asks for a move.
+        if (worker_i > 0)
+            pthread_create(&worker_p->thread, NULL, Ai_Worker_Thread, worker_p);
+    }
+}
+
+
+/*
+ * Stop the worker threads of a computer player, and free its memory.
+ * Receives a pointer to the AI.
+ */
+void Ai_Free(AI_PLAYER* ai_p)
+{
+    // Wake the waiting workers to end their threads.
+    pthread_mutex_lock(&ai_p->mutex);
+    ai_p->is_stopping = true;
+    pthread_cond_broadcast(&ai_p->start_cond);
+    pthread_mutex_unlock(&ai_p->mutex);
+
+    for (int worker_i = 0; worker_i < ai_p->nof_workers; worker_i++)
+    {
+        if (worker_i > 0)
+            pthread_join(ai_p->workers[worker_i].thread, NULL);
+
+        Arena_Free(&ai_p->workers[worker_i].arena);
+        free(ai_p->workers[worker_i].game_p);
+    }
+
+    pthread_mutex_destroy(&ai_p->mutex);
+    pthread_cond_destroy(&ai_p->start_cond);
+    pthread_cond_destroy(&ai_p->done_cond);
+    free(ai_p->root_game_p);
+    free(ai_p->workers);
+}
+
+
+/*
+ * Let the computer choose the move of the current player: search the game on all the workers until the time of the move ends,
+ * then choose the move that the rollouts played most. A COLOR card comes with its color, and every card of a TAKI sequence is chosen by its own search.
+ * Receives a pointer to the game's data and the context pointer (matches CHOOSE_MOVE_FUNC): the AI.
+ * Returns the chosen move.
+ */
+MOVE Choose_Ai_Move(const GAME_DATA* game_data_p, void* context_p)
+{
+    AI_PLAYER* ai_p = (AI_PLAYER*) context_p; // The AI.
+    uint64_t move_codes = Ai_Get_Move_Codes(game_data_p); // The legal moves of the player.
+    unsigned long long nof_visits[NOF_MOVE_CODES] = { 0 }; // How many rollouts played every move, in all the trees.
+    int best_code = EMPTY; // The move played most.
+    struct timespec now; // The time the search starts.
+
+    // Check if there is nothing to choose, or the game has more players than the search can score.
+    if (__builtin_popcountll(move_codes) == 1)
+        return Log_Decode_Move((unsigned char) __builtin_ctzll(move_codes));
+    if (game_data_p->nof_players > MAX_SIM_PLAYERS)
+        return Choose_Auto_Move(game_data_p, NULL);
+
+    // Set the searched game and the time the search ends.
+    Game_Snapshot(game_data_p, ai_p->root_game_p);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    ai_p->deadline.tv_sec = now.tv_sec + (time_t) ai_p->seconds_per_move;
+    ai_p->deadline.tv_nsec = now.tv_nsec + (long) ((ai_p->seconds_per_move - (time_t) ai_p->seconds_per_move) * 1e9);
+    if (ai_p->deadline.tv_nsec >= 1000000000L)
+    {
+        ai_p->deadline.tv_sec++;
+        ai_p->deadline.tv_nsec -= 1000000000L;
+    }
+
+    // Start the search on the waiting workers, search on this thread too, then wait for the other workers.
+    pthread_mutex_lock(&ai_p->mutex);
+    ai_p->search_i++;
+    ai_p->nof_busy = ai_p->nof_workers - 1;
+    pthread_cond_broadcast(&ai_p->start_cond);
+    pthread_mutex_unlock(&ai_p->mutex);
+
+    Ai_Search(&ai_p->workers[0]);
+
+    pthread_mutex_lock(&ai_p->mutex);
+    while (ai_p->nof_busy > 0)
+        pthread_cond_wait(&ai_p->done_cond, &ai_p->mutex);
+    pthread_mutex_unlock(&ai_p->mutex);
+
+    // Add together the moves of the roots of all the trees.
+    for (int worker_i = 0; worker_i < ai_p->nof_workers; worker_i++)
+        for (AI_NODE* child_p = ai_p->workers[worker_i].root_p->first_child; child_p != NULL; child_p = child_p->next_sibling)
+            nof_visits[child_p->move_code] += child_p->nof_visits;
+
+    // Choose the move played most, it is the move the search trusts most.
+    for (uint64_t codes = move_codes; codes != 0; codes &= codes - 1)
+    {
+        int code = __builtin_ctzll(codes); // The lowest move code left.
+
+        if (best_code == EMPTY || nof_visits[code] > nof_visits[best_code])
+            best_code = code;
+    }
+
+    return Log_Decode_Move((unsigned char) best_code);
+}
+
+
+/*
+ * The main function of a worker thread of the AI. Waits for a search to start, searches until its time ends, and waits again.
+ * Receives a pointer to the worker (void* to match pthread_create).
+ */
+void* Ai_Worker_Thread(void* worker_vp)
+{
+    AI_WORKER* worker_p = (AI_WORKER*) worker_vp; // The worker running on this thread.
+    AI_PLAYER* ai_p = worker_p->ai_p; // The AI of the worker.
+    unsigned long long search_i = 0; // The number of the last search of the worker.
+
+    while (true)
+    {
+        // Wait for a new search, or for the AI to stop.
+        pthread_mutex_lock(&ai_p->mutex);
+        while (ai_p->search_i == search_i && !ai_p->is_stopping)
+            pthread_cond_wait(&ai_p->start_cond, &ai_p->mutex);
+        if (ai_p->is_stopping)
+        {
+            pthread_mutex_unlock(&ai_p->mutex);
+            return NULL;
+        }
+        search_i = ai_p->search_i;
+        pthread_mutex_unlock(&ai_p->mutex);
+
+        Ai_Search(worker_p);
+
+        // Tell the chooser when the last worker finished.
+        pthread_mutex_lock(&ai_p->mutex);
+        if (--ai_p->nof_busy == 0)
+            pthread_cond_signal(&ai_p->done_cond);
+        pthread_mutex_unlock(&ai_p->mutex);
+    }
+}
+
+
+/*
+ * Grow a new tree of the searched game until the time of the move ends.
+ * The search is anytime: the tree always has the best moves found so far, and the time is checked every few rollouts.
+ * Receives a pointer to the worker.
+ */
+void Ai_Search(AI_WORKER* worker_p)
+{
+    const struct timespec* deadline_p = &worker_p->ai_p->deadline; // When the search needs to stop.
+    struct timespec now; // The current time.
+
+    Arena_Reset(&worker_p->arena); // The tree of the last move isn't needed.
+    worker_p->root_p = Ai_Add_Child(worker_p, NULL, 0, EMPTY);
+    worker_p->nof_rollouts = 0;
+
+    do
+    {
+        for (int rollout_i = 0; rollout_i <= AI_CLOCK_CHECK_MASK; rollout_i++)
+            Ai_Rollout_Once(worker_p);
+        worker_p->nof_rollouts += AI_CLOCK_CHECK_MASK + 1;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    }
+    while (now.tv_sec < deadline_p->tv_sec || (now.tv_sec == deadline_p->tv_sec && now.tv_nsec < deadline_p->tv_nsec));
+}
+
+
+/*
+ * Play one rollout: guess the hidden cards, go down the tree with the moves that are legal in the guess, add one new move to the tree,
+ * play the rest of the game with random moves, and add the result to every move on the way.
+ * Receives a pointer to the worker.
+ */
+void Ai_Rollout_Once(AI_WORKER* worker_p)
+{
+    GAME_DATA* game_data_p = Game_Clone(worker_p->game_p, worker_p->ai_p->root_game_p); // The guessed game, played by the rollout.
+    AI_NODE* path[AI_MAX_TREE_DEPTH + 1]; // The nodes the rollout went through, from the root.
+    int depth = 0; // The number of nodes in the path.
+    AI_NODE* node_p = worker_p->root_p; // The current node.
+    double rewards[MAX_SIM_PLAYERS]; // The result of the rollout for every player.
+
+    Ai_Guess_Hidden_Cards(game_data_p, game_data_p->player_index, &worker_p->rng);
+    path[depth++] = node_p;
+
+    // Go down the tree until a move is added to it.
+    while (!game_data_p->is_game_won && depth <= AI_MAX_TREE_DEPTH)
+    {
+        uint64_t move_codes = Ai_Get_Move_Codes(game_data_p); // The legal moves in this guess.
+        uint64_t new_codes = move_codes & ~node_p->child_mask; // The legal moves that aren't in the tree yet.
+
+        // Count the moves of the tree that are legal in this guess.
+        for (AI_NODE* child_p = node_p->first_child; child_p != NULL; child_p = child_p->next_sibling)
+            if ((move_codes >> child_p->move_code) & 1)
+                child_p->nof_avails++;
+
+        if (new_codes != 0)
+            node_p = Ai_Add_Child(worker_p, node_p, (unsigned char) Pick_Random_Bit(new_codes, &worker_p->rng), game_data_p->player_index);
+        else
+            node_p = Ai_Select_Child(node_p, move_codes);
+
+        Engine_Apply_Move(game_data_p, Log_Decode_Move(node_p->move_code));
+        path[depth++] = node_p;
+
+        if (new_codes != 0)
+            break; // The new move is played by the rollout from here.
+    }
+
+    Ai_Play_Rollout(game_data_p, &worker_p->rng, rewards);
+
+    // Add the result to every move on the way, for the player who made the move.
+    for (int path_i = 0; path_i < depth; path_i++)
+    {
+        path[path_i]->nof_visits++;
+        if (path[path_i]->player_index != EMPTY)
+            path[path_i]->reward += rewards[path[path_i]->player_index];
+    }
+}
+
+
+/*
+ * Guess the cards a player can't see: the other players' hands and the draw pile.
+ * With a finite deck, the cards that aren't in the player's hand, on the top of the deck or in the discard pile are shuffled,
+ * dealt to the other players by their numbers of cards, and the rest become the draw pile. With an infinite deck the other hands get random cards.
+ * The game's random numbers are changed too, so the guess doesn't know the real cards that will be drawn.
+ * Receives a pointer to the game's data, the index of the player and a pointer to the random numbers generator of the guess.
+ */
+void Ai_Guess_Hidden_Cards(GAME_DATA* game_data_p, int player_index, RNG* rng_p)
+{
+    DECK* deck_p = &game_data_p->deck; // The game's deck.
+    CARD hidden_cards[MAX_DECK_SIZE]; // The cards the player didn't see, shuffled.
+    int nof_hidden = 0; // The number of hidden cards left to deal.
+
+    if (deck_p->is_finite)
+    {
+        int counts[FIRST_COLOR_CODE + 1]; // How many cards of every card code are hidden.
+        CARD top_card = game_data_p->top_card; // The top card, a COLOR card returns to the deck without its color.
+
+        // Take out of the deck the cards the player sees.
+        for (int card = 0; card <= FIRST_COLOR_CODE; card++)
+            counts[card] = deck_p->counts[card] - (int) game_data_p->players[player_index].hand.counts[card];
+        counts[Get_Card_Type(top_card) == TYPE_COLOR ? FIRST_COLOR_CODE : top_card]--;
+        for (int card_i = DECK_ARRAY_SIZE - deck_p->nof_discard; card_i < DECK_ARRAY_SIZE; card_i++)
+            counts[deck_p->cards[card_i]]--;
+
+        for (int card = 0; card <= FIRST_COLOR_CODE; card++)
+            for (int copy_i = 0; copy_i < counts[card]; copy_i++)
+                hidden_cards[nof_hidden++] = (CARD) card;
+
+        Shuffle_Cards(hidden_cards, nof_hidden, rng_p);
+    }
+
+    // Deal the other players the same numbers of cards they have.
+    for (int player_i = 0; player_i < game_data_p->nof_players; player_i++)
+    {
+        HAND* hand_p = &game_data_p->players[player_i].hand; // The hand being guessed.
+        int nof_cards = hand_p->nof_cards; // The number of cards of the hand.
+        CARD card; // The guessed card.
+
+        if (player_i == player_index)
+            continue;
+
+        Hand_Init(hand_p);
+        for (int card_i = 0; card_i < nof_cards; card_i++)
+        {
+            if (!deck_p->is_finite)
+                Take_Random_Card(rng_p, &card);
+            else if (nof_hidden > 0)
+                card = hidden_cards[--nof_hidden];
+            else
+                break;
+
+            Hand_Add(hand_p, card);
+        }
+    }
+
+    // The cards left are the draw pile.
+    if (deck_p->is_finite)
+    {
+        memcpy(deck_p->cards, hidden_cards, nof_hidden);
+        deck_p->nof_draw = nof_hidden;
+    }
+
+    game_data_p->rng.state ^= ((uint64_t) Rng_Next(rng_p) << 32) | Rng_Next(rng_p);
+}
+
+
+/*
+ * Play the rest of a game with random moves: every player drops a random card that can be dropped, or draws a card if he has none.
+ * A COLOR card takes the color the player has most cards of.
+ * A game that doesn't finish after AI_ROLLOUT_MAX_MOVES moves is scored by the players' numbers of cards.
+ * Receives a pointer to the game's data, a pointer to the random numbers generator of the rollout and an array for the result of every player.
+ */
+void Ai_Play_Rollout(GAME_DATA* game_data_p, RNG* rng_p, double rewards[])
+{
+    double sum = 0; // The sum of the players' scores of an unfinished game.
+
+    for (int move_i = 0; move_i < AI_ROLLOUT_MAX_MOVES && !game_data_p->is_game_won; move_i++)
+    {
+        uint64_t plays = Get_Legal_Plays(game_data_p); // The card codes that can be dropped.
+        MOVE move; // The random move.
+
+        if (plays == 0)
+            move = Engine_Default_Move(game_data_p);
+        else
+        {
+            move.kind = MOVE_PLAY;
+            move.card = (CARD) Pick_Random_Bit(plays, rng_p);
+            move.color = Ai_Best_Color(&game_data_p->players[game_data_p->player_index].hand, game_data_p->top_card);
+        }
+
+        Engine_Apply_Move(game_data_p, move);
+    }
+
+    // The winner gets the whole reward.
+    if (game_data_p->is_game_won)
+    {
+        for (int player_i = 0; player_i < game_data_p->nof_players; player_i++)
+            rewards[player_i] = (player_i == game_data_p->winner_index) ? 1 : 0;
+        return;
+    }
+
+    // Without a winner, a player with fewer cards gets a bigger part of the reward.
+    for (int player_i = 0; player_i < game_data_p->nof_players; player_i++)
+    {
+        rewards[player_i] = 1.0 / (1 + game_data_p->players[player_i].hand.nof_cards);
+        sum += rewards[player_i];
+    }
+    for (int player_i = 0; player_i < game_data_p->nof_players; player_i++)
+        rewards[player_i] /= sum;
+}
+
+
+/*
+ * Choose the move of the tree to go down to, among the moves that are legal in the current guess (UCB1 over the times the move was legal).
+ * Receives a pointer to the node, all of its legal moves are already in the tree, and the legal moves.
+ * Returns a pointer to the chosen child.
+ */
+AI_NODE* Ai_Select_Child(AI_NODE* node_p, uint64_t move_codes)
+{
+    AI_NODE* best_p = NULL; // The child with the best score.
+    double best_score = 0; // The score of the best child.
+
+    for (AI_NODE* child_p = node_p->first_child; child_p != NULL; child_p = child_p->next_sibling)
+    {
+        double score; // The average reward of the move, plus a bonus for moves that were tried less.
+
+        if (!((move_codes >> child_p->move_code) & 1))
+            continue; // The move isn't legal in this guess.
+
+        score = child_p->reward / child_p->nof_visits + AI_UCB_CONSTANT * sqrt(log((double) child_p->nof_avails) / child_p->nof_visits);
+        if (best_p == NULL || score > best_score)
+        {
+            best_p = child_p;
+            best_score = score;
+        }
+    }
+
+    return best_p;
+}
+
+
+/*
+ * Add a move to the tree, after a node. The node is allocated from the worker's arena.
+ * Receives a pointer to the worker, a pointer to the parent node (NULL for the root), the move and the player who makes it (EMPTY for the root).
+ * Returns a pointer to the new node.
+ */
+AI_NODE* Ai_Add_Child(AI_WORKER* worker_p, AI_NODE* node_p, unsigned char move_code, int player_index)
+{
+    AI_NODE* child_p = (AI_NODE*) Arena_Alloc(&worker_p->arena, sizeof(AI_NODE)); // The new node.
+
+    child_p->first_child = NULL;
+    child_p->child_mask = 0;
+    child_p->reward = 0;
+    child_p->nof_visits = 0;
+    child_p->nof_avails = 1; // The move is legal now.
+    child_p->player_index = player_index;
+    child_p->move_code = move_code;
+    child_p->next_sibling = NULL;
+
+    // Link the new node first in its parent's children.
+    if (node_p != NULL)
+    {
+        child_p->next_sibling = node_p->first_child;
+        node_p->first_child = child_p;
+        node_p->child_mask |= 1ULL << move_code;
+    }
+
+    return child_p;
+}
+
+
+/*
+ * Get the legal moves of the current player as a mask of move codes (Log_Encode_Move).
+ * A COLOR card outside of a TAKI sequence is a different move for every color.
+ * Receives a pointer to the game's data.
+ * Returns the mask, bit i is set if the move code i is legal.
+ */
+uint64_t Ai_Get_Move_Codes(const GAME_DATA* game_data_p)
+{
+    uint64_t move_codes = Get_Legal_Plays(game_data_p); // The card codes that can be dropped are their move codes.
+
+    if (game_data_p->is_game_won)
+        return 0;
+
+    // Replace the COLOR card with its move codes for every color.
+    if (!game_data_p->is_taki_open && (move_codes & COLOR_CARDS_MASK))
+        move_codes = (move_codes & ~COLOR_CARDS_MASK) | (0xFULL << (FIRST_COLOR_CODE + COLOR_YELLOW));
+
+    // Drawing a card, or closing the TAKI sequence, is always possible.
+    return move_codes | (1ULL << (game_data_p->is_taki_open ? LOG_END_TAKI : LOG_DRAW));
+}
+
+
+/*
+ * Choose the color of a COLOR card: the color the player has most cards of, or the color of the top card if the player has no colored cards.
+ * Receives a pointer to the player's hand and the top card.
+ * Returns the chosen color.
+ */
+CARD_COLOR Ai_Best_Color(const HAND* hand_p, CARD top_card)
+{
+    CARD_COLOR best_color = Is_Valid_Color(Get_Card_Color(top_card)) ? Get_Card_Color(top_card) : COLOR_YELLOW; // The chosen color.
+
+    for (int color = COLOR_YELLOW; color <= COLOR_GREEN; color++)
+        if (hand_p->color_counts[color] > hand_p->color_counts[best_color])
+            best_color = (CARD_COLOR) color;
+
+    return best_color;
+}
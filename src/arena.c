@@ -0,0 +1,157 @@
+#include "header.h"
+
+// -------------------- Arena Functions ---------------------
+// An arena hands out memory from big chunks by moving a pointer, and frees all of it at once.
+// The simulation gives every worker thread its own arena, and resets it after every game.
+// The chunks are kept after a reset, so once the chunks are big enough the games don't call malloc or free at all.
+
+/*
+ * Initialize an empty arena. No memory is allocated until the first allocation.
+ * Receives a pointer to the arena and the size of its chunks in bytes.
+ */
+void Arena_Init(ARENA* arena_p, size_t chunk_size)
+{
+    arena_p->first = NULL;
+    arena_p->current = NULL;
+    arena_p->chunk_size = chunk_size;
+    arena_p->nof_system_allocs = 0;
+}
+
+
+/*
+ * Allocate memory from the arena. The memory is aligned to ARENA_ALIGNMENT.
+ * Uses the current chunk, then the chunks kept from before the last reset, and only then allocates a new chunk with malloc.
+ * Receives a pointer to the arena and the size of the wanted memory in bytes.
+ * If the allocation failed, prints error message and ends the program.
+ * Returns a pointer to the allocated memory.
+ */
+void* Arena_Alloc(ARENA* arena_p, size_t size)
+{
+    ARENA_CHUNK* chunk_p = arena_p->current; // The chunk the memory is taken from.
+    void* block; // The allocated memory.
+
+    size = Arena_Align_Size(size);
+
+    // Move to the next chunk until a chunk has enough free space.
+    while (chunk_p == NULL || chunk_p->size - chunk_p->used < size)
+    {
+        ARENA_CHUNK* next_p = (chunk_p == NULL) ? arena_p->first : chunk_p->next; // The chunk after the current chunk.
+
+        // Check if all the chunks are full, then add a new chunk after the current chunk.
+        if (next_p == NULL || next_p->size < size)
+        {
+            next_p = Arena_New_Chunk(arena_p, size > arena_p->chunk_size ? size : arena_p->chunk_size);
+
+            // Keep the chunks that are after the current chunk after the new chunk.
+            if (chunk_p == NULL)
+            {
+                next_p->next = arena_p->first;
+                arena_p->first = next_p;
+            }
+            else
+            {
+                next_p->next = chunk_p->next;
+                chunk_p->next = next_p;
+            }
+        }
+
+        next_p->used = 0; // The chunk is empty again after a reset.
+        chunk_p = next_p;
+    }
+
+    block = chunk_p->data + chunk_p->used;
+    chunk_p->used += size;
+    arena_p->current = chunk_p;
+
+    return block;
+}
+
+
+/*
+ * Grow a block of memory that was allocated from the arena.
+ * If the block is the last block allocated from the current chunk and the chunk has space, the block grows in place.
+ * Otherwise allocates a new block and copies the old block into it (the old block's memory returns to the arena on the next reset).
+ * Receives a pointer to the arena, the block, its size in bytes and the wanted new size in bytes.
+ * Returns a pointer to the grown block.
+ */
+void* Arena_Grow(ARENA* arena_p, void* block, size_t old_size, size_t new_size)
+{
+    ARENA_CHUNK* chunk_p = arena_p->current; // The chunk the last block was allocated from.
+    void* new_block; // The grown block.
+
+    old_size = Arena_Align_Size(old_size);
+    new_size = Arena_Align_Size(new_size);
+
+    // Check if the block is at the end of the used part of the current chunk, and the chunk has space for the new size.
+    if (chunk_p != NULL && (unsigned char*) block + old_size == chunk_p->data + chunk_p->used
+        && chunk_p->size - chunk_p->used >= new_size - old_size)
+    {
+        chunk_p->used += new_size - old_size; // Grow in place.
+        return block;
+    }
+
+    new_block = Arena_Alloc(arena_p, new_size);
+    memcpy(new_block, block, old_size);
+
+    return new_block;
+}
+
+
+/*
+ * Free all the memory allocated from the arena at once. The chunks are kept for the next allocations.
+ * Doesn't depend on the number of chunks or allocations.
+ * Receives a pointer to the arena.
+ */
+void Arena_Reset(ARENA* arena_p)
+{
+    arena_p->current = arena_p->first;
+
+    if (arena_p->first != NULL)
+        arena_p->first->used = 0; // The other chunks are emptied when the allocations reach them.
+}
+
+
+/*
+ * Free the chunks of the arena with the free function. The arena is empty after it, and can be used again.
+ * Receives a pointer to the arena.
+ */
+void Arena_Free(ARENA* arena_p)
+{
+    ARENA_CHUNK* chunk_p = arena_p->first; // The chunk to free.
+
+    while (chunk_p != NULL)
+    {
+        ARENA_CHUNK* next_p = chunk_p->next; // Keep the next chunk before freeing the current chunk.
+        free(chunk_p);
+        chunk_p = next_p;
+    }
+
+    arena_p->first = NULL;
+    arena_p->current = NULL;
+}
+
+
+/*
+ * Allocate a new chunk for the arena with malloc. The chunk isn't linked to the arena's chunks.
+ * Receives a pointer to the arena and the size of the chunk's data in bytes.
+ * If the allocation failed, prints error message and ends the program.
+ * Returns a pointer to the new chunk.
+ */
+ARENA_CHUNK* Arena_New_Chunk(ARENA* arena_p, size_t size)
+{
+    ARENA_CHUNK* chunk_p = (ARENA_CHUNK*) malloc(sizeof(ARENA_CHUNK) + size); // The new chunk.
+
+    // Check if the allocation failed.
+    if (chunk_p == NULL)
+    {
+        printf("Memory allocation failed!!!\n");
+        exit(1); // Stop the program.
+    }
+
+    chunk_p->next = NULL;
+    chunk_p->size = size;
+    chunk_p->used = 0;
+    arena_p->nof_system_allocs++;
+
+    return chunk_p;
+}
@@ -0,0 +1,502 @@
+#include "header.h"
+
+// -------------------- Benchmark Functions ---------------------
+// Times the hot paths of the engine, to compare builds and catch slowdowns.
+// Every benchmark runs a fixed number of operations in every repetition. A few untimed repetitions warm it up,
+// then every repetition is timed alone, and the fastest, median, 90th and 99th percentile and slowest times per operation are reported.
+// The inputs are random cards made with a fixed seed before the timing, so every run times the same work.
+// Build with optimizations: gcc -O2 -pthread bench.c functions.c engine.c ... -o bench -lm -ldl
+
+/*
+ * Run the benchmarks, print their results and write them as JSON.
+ * Usage: bench [json file|-] [repetitions] [warmup]. "-" writes the JSON to the screen instead of the table.
+ */
+int main(int argc, char* argv[])
+{
+    BENCH_SUITE suite; // The results of all the benchmarks.
+    const char* json_path = argc > 1 ? argv[1] : NULL; // Where the JSON results are written, NULL to only print the table.
+    bool is_json_stdout = json_path != NULL && !strcmp(json_path, "-"); // True to write the JSON to the screen.
+    FILE* json_file_p; // The JSON file.
+
+    suite.nof_results = 0;
+    suite.repetitions = argc > 2 ? atoi(argv[2]) : BENCH_REPETITIONS;
+    suite.warmup = argc > 3 ? atoi(argv[3]) : BENCH_WARMUP;
+
+    // Check the settings.
+    if (suite.repetitions < 1 || suite.repetitions > BENCH_MAX_REPETITIONS || suite.warmup < 0)
+    {
+        printf("Usage: bench [json file|-] [repetitions 1-%d] [warmup]\n", BENCH_MAX_REPETITIONS);
+        return 1;
+    }
+
+    Run_All_Benchmarks(&suite);
+
+    if (!is_json_stdout)
+        Print_Bench_Results(&suite);
+
+    if (json_path == NULL)
+        return 0;
+
+    // Write the results as JSON.
+    json_file_p = is_json_stdout ? stdout : fopen(json_path, "w");
+    if (json_file_p == NULL)
+    {
+        printf("Can't open the file %s!!!\n", json_path);
+        return 1;
+    }
+    Write_Bench_Json(&suite, json_file_p);
+    if (!is_json_stdout)
+        fclose(json_file_p);
+
+    return 0;
+}
+
+
+/*
+ * Run every benchmark, with the number of operations per repetition set so a repetition takes about a millisecond.
+ * Receives a pointer to the suite the results are added to.
+ */
+void Run_All_Benchmarks(BENCH_SUITE* suite_p)
+{
+    BENCH_CONTEXT context; // The inputs and the game of the benchmarks.
+
+    Bench_Init_Context(&context);
+
+    Run_Benchmark(suite_p, "Take_Random_Card", 0, Bench_Take_Random_Card, &context, 100000);
+    Run_Benchmark(suite_p, "Check_Normal_Card", 0, Bench_Check_Normal_Card, &context, 200000);
+    Run_Benchmark(suite_p, "Check_Special_Card", 0, Bench_Check_Special_Card, &context, 200000);
+    Run_Benchmark(suite_p, "Try_Play_Card", 0, Bench_Try_Play_Card, &context, 100000);
+    Run_Benchmark(suite_p, "Draw_New_Card", 0, Bench_Draw_New_Card, &context, 100000);
+    Run_Benchmark(suite_p, "Draw_New_Card (finite deck)", 0, Bench_Draw_Finite_Card, &context, 100000);
+    Run_Benchmark(suite_p, "Draw_New_Card + Reallocate_Cards_Array", BENCH_NOF_INPUTS, Bench_Cards_Array_Growth, &context, 25 * BENCH_NOF_INPUTS);
+
+    // The hand functions at every hand size. A hand is a multiset of counts, so removing a card shouldn't depend on the size,
+    // while the printed cards array is built again from the whole hand.
+    for (int hand_size = BENCH_MIN_HAND_SIZE; hand_size <= BENCH_MAX_HAND_SIZE; hand_size *= 4)
+    {
+        context.hand_size = hand_size;
+        Run_Benchmark(suite_p, "Hand_Remove + Hand_Add", hand_size, Bench_Hand_Remove, &context, 100000);
+        Run_Benchmark(suite_p, "Update_Cards_Array", hand_size, Bench_Update_Cards_Array, &context, 2000000 / (hand_size + 16));
+    }
+
+    Run_Benchmark(suite_p, "Sort_Stats_Array", context.nof_stats, Bench_Sort_Stats_Array, &context, 20000);
+    Run_Benchmark(suite_p, "Full headless game", 4, Bench_Full_Games, &context, 100);
+
+    Bench_Free_Context(&context);
+}
+
+
+/*
+ * Time a benchmark: run its warmup repetitions, then time every repetition, and add the times per operation to the suite.
+ * Receives a pointer to the suite, the name of the benchmark, its size parameter (0 if it has none),
+ * the benchmark function, its context and the number of operations in every repetition.
+ */
+void Run_Benchmark(BENCH_SUITE* suite_p, const char* name, long long param, BENCH_FUNC bench_func, BENCH_CONTEXT* context_p, long long ops_per_rep)
+{
+    double times[BENCH_MAX_REPETITIONS]; // The time of one operation in every repetition, in nanoseconds.
+    double sum = 0; // The sum of the times.
+    BENCH_RESULT* result_p; // The result of the benchmark.
+    struct timespec start_time, end_time; // The time a repetition started and finished.
+
+    if (suite_p->nof_results >= BENCH_MAX_RESULTS)
+        return;
+
+    if (ops_per_rep < 1)
+        ops_per_rep = 1;
+
+    for (int rep_i = 0; rep_i < suite_p->warmup; rep_i++)
+        bench_func(context_p, ops_per_rep);
+
+    // Time every repetition alone, so a repetition slowed by the system shows in the high percentiles instead of the median.
+    for (int rep_i = 0; rep_i < suite_p->repetitions; rep_i++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        bench_func(context_p, ops_per_rep);
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+        times[rep_i] = ((end_time.tv_sec - start_time.tv_sec) * 1e9 + (end_time.tv_nsec - start_time.tv_nsec)) / ops_per_rep;
+        sum += times[rep_i];
+    }
+
+    qsort(times, suite_p->repetitions, sizeof(double), Compare_Doubles);
+
+    result_p = &suite_p->results[suite_p->nof_results++];
+    result_p->name = name;
+    result_p->param = param;
+    result_p->ops_per_rep = ops_per_rep;
+    result_p->min = times[0];
+    result_p->p50 = Get_Percentile(times, suite_p->repetitions, 50);
+    result_p->p90 = Get_Percentile(times, suite_p->repetitions, 90);
+    result_p->p99 = Get_Percentile(times, suite_p->repetitions, 99);
+    result_p->max = times[suite_p->repetitions - 1];
+    result_p->mean = sum / suite_p->repetitions;
+}
+
+
+/*
+ * Get a percentile of sorted values, by the nearest rank.
+ * Receives the sorted values, their number and the percentile (0-100).
+ */
+double Get_Percentile(const double sorted[], int nof_values, double percentile)
+{
+    int rank = (int) ceil(percentile / 100 * nof_values); // The rank of the value, from 1.
+
+    if (rank < 1)
+        rank = 1;
+    if (rank > nof_values)
+        rank = nof_values;
+
+    return sorted[rank - 1];
+}
+
+
+/*
+ * Compare two doubles, for qsort.
+ * Receives pointers to the two doubles.
+ * Returns a negative number if the first is smaller, a positive number if it is bigger, 0 if they are equal.
+ */
+int Compare_Doubles(const void* a_p, const void* b_p)
+{
+    double a = *(const double*) a_p, b = *(const double*) b_p; // The doubles.
+
+    return (a > b) - (a < b);
+}
+
+
+/*
+ * Print the results of the benchmarks as a table.
+ * Receives a pointer to the suite.
+ */
+void Print_Bench_Results(const BENCH_SUITE* suite_p)
+{
+    printf("\n************ Benchmark Results ************\n");
+    printf("%d repetitions after %d warmup repetitions, nanoseconds per operation\n\n", suite_p->repetitions, suite_p->warmup);
+    printf("%-40s %6s %11s %11s %11s %11s %14s\n", "Benchmark", "Size", "min", "p50", "p90", "p99", "ops/sec (p50)");
+
+    for (int result_i = 0; result_i < suite_p->nof_results; result_i++)
+    {
+        const BENCH_RESULT* result_p = &suite_p->results[result_i]; // The result to print.
+
+        printf("%-40s %6lld %11.1f %11.1f %11.1f %11.1f %14.0f\n", result_p->name, result_p->param,
+               result_p->min, result_p->p50, result_p->p90, result_p->p99, result_p->p50 > 0 ? 1e9 / result_p->p50 : 0.0);
+    }
+}
+
+
+/*
+ * Write the results of the benchmarks as JSON: the settings of the run and the build, and the times of every benchmark.
+ * Receives a pointer to the suite and the file to write to.
+ */
+void Write_Bench_Json(const BENCH_SUITE* suite_p, FILE* file_p)
+{
+    fprintf(file_p, "{\n");
+    fprintf(file_p, "  \"format\": 1,\n");
+    fprintf(file_p, "  \"time\": %lld,\n", (long long) time(NULL));
+    fprintf(file_p, "  \"compiler\": \"%s\",\n", __VERSION__);
+#ifdef __OPTIMIZE__
+    fprintf(file_p, "  \"optimized\": true,\n");
+#else
+    fprintf(file_p, "  \"optimized\": false,\n");
+#endif
+    fprintf(file_p, "  \"repetitions\": %d,\n", suite_p->repetitions);
+    fprintf(file_p, "  \"warmup\": %d,\n", suite_p->warmup);
+    fprintf(file_p, "  \"unit\": \"ns/op\",\n");
+    fprintf(file_p, "  \"results\": [\n");
+
+    for (int result_i = 0; result_i < suite_p->nof_results; result_i++)
+    {
+        const BENCH_RESULT* result_p = &suite_p->results[result_i]; // The result to write.
+
+        fprintf(file_p, "    {\"name\": \"%s\", \"param\": %lld, \"ops_per_rep\": %lld, "
+                        "\"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, \"mean\": %.3f, \"ops_per_sec\": %.1f}%s\n",
+                result_p->name, result_p->param, result_p->ops_per_rep,
+                result_p->min, result_p->p50, result_p->p90, result_p->p99, result_p->max, result_p->mean,
+                result_p->p50 > 0 ? 1e9 / result_p->p50 : 0.0, result_i + 1 < suite_p->nof_results ? "," : "");
+    }
+
+    fprintf(file_p, "  ]\n}\n");
+}
+
+
+/*
+ * Prepare the inputs of the benchmarks: a game of 2 players, random cards with top cards they can be dropped on, and unsorted stats.
+ * Receives a pointer to the context.
+ */
+void Bench_Init_Context(BENCH_CONTEXT* context_p)
+{
+    unsigned long long card_freqs[NOF_CARD_CODES]; // Random frequencies for the stats.
+    GAME_DATA* game_data_p = &context_p->game_data; // The benchmarks' game.
+
+    Rng_Seed(&context_p->rng, BENCH_SEED, 0);
+    Engine_Init_Game(game_data_p, 2, BENCH_SEED, 0, NULL, NULL);
+    Arena_Init(&context_p->arena, ARENA_CHUNK_SIZE);
+    context_p->sink = 0;
+    context_p->hand_size = BENCH_MIN_HAND_SIZE;
+
+    // Random cards, each with a top card it can be dropped on. The top cards are normal cards, so every color and number meet.
+    for (int input_i = 0; input_i < BENCH_NOF_INPUTS; input_i++)
+    {
+        do
+        {
+            Take_Random_Card(&context_p->rng, &context_p->cards[input_i]);
+            Deck_Draw_Normal_Card(&game_data_p->deck, &context_p->rng, &context_p->top_cards[input_i]);
+            context_p->colors[input_i] = Get_Random_Color(&context_p->rng);
+            game_data_p->top_card = context_p->top_cards[input_i];
+        }
+        while (!Check_Play_Card(game_data_p, context_p->cards[input_i], context_p->colors[input_i]));
+    }
+
+    // The stats of random frequencies.
+    for (int card = 0; card < NOF_CARD_CODES; card++)
+        card_freqs[card] = Rng_Next(&context_p->rng) % 1000;
+    context_p->nof_stats = Build_Stats_View(card_freqs, context_p->stats);
+}
+
+
+/*
+ * Free the game and the arena of the benchmarks.
+ * Receives a pointer to the context.
+ */
+void Bench_Free_Context(BENCH_CONTEXT* context_p)
+{
+    Engine_Free_Game(&context_p->game_data);
+    Arena_Free(&context_p->arena);
+}
+
+
+/*
+ * Give the first player a new hand of random cards, and build his cards array.
+ * Receives a pointer to the context and the number of cards.
+ */
+void Bench_Fill_Hand(BENCH_CONTEXT* context_p, int nof_cards)
+{
+    PLAYER* player_p = &context_p->game_data.players[0]; // The player of the benchmarks.
+
+    Hand_Init(&player_p->hand);
+    for (int card_i = 0; card_i < nof_cards; card_i++)
+        Hand_Add(&player_p->hand, context_p->cards[card_i % BENCH_NOF_INPUTS]);
+
+    player_p->is_cards_array_updated = false;
+    Update_Cards_Array(&context_p->game_data, player_p);
+}
+
+
+/*
+ * Take random cards of the infinite deck.
+ * Receives a pointer to the context and the number of cards.
+ */
+void Bench_Take_Random_Card(BENCH_CONTEXT* context_p, long long nof_ops)
+{
+    CARD card; // The random card.
+
+    for (long long op_i = 0; op_i < nof_ops; op_i++)
+    {
+        Take_Random_Card(&context_p->rng, &card);
+        context_p->sink += card;
+    }
+}
+
+
+/*
+ * Check if random normal cards can be dropped on random top cards.
+ * Receives a pointer to the context and the number of checks.
+ */
+void Bench_Check_Normal_Card(BENCH_CONTEXT* context_p, long long nof_ops)
+{
+    for (long long op_i = 0; op_i < nof_ops; op_i++)
+    {
+        CARD normal_card = (CARD) (op_i % FIRST_SPECIAL_CODE); // Every normal card code.
+        CARD top_card = context_p->top_cards[op_i & (BENCH_NOF_INPUTS - 1)]; // The top card to check it on.
+
+        context_p->sink += Check_Normal_Card(normal_card, top_card);
+    }
+}
+
+
+/*
+ * Check if random special cards can be dropped on random top cards.
+ * Receives a pointer to the context and the number of checks.
+ */
+void Bench_Check_Special_Card(BENCH_CONTEXT* context_p, long long nof_ops)
+{
+    for (long long op_i = 0; op_i < nof_ops; op_i++)
+    {
+        CARD special_card = (CARD) (FIRST_SPECIAL_CODE + op_i % (FIRST_COLOR_CODE + 1 - FIRST_SPECIAL_CODE)); // Every special card in a hand.
+        CARD top_card = context_p->top_cards[op_i & (BENCH_NOF_INPUTS - 1)]; // The top card to check it on.
+
+        context_p->sink += Check_Special_Card(special_card, top_card);
+    }
+}
+
+
+/*
+ * Drop cards that can be dropped, with their effects. Every card is given to the player just before it is dropped,
+ * and the player keeps a big hand, so the PLUS cards don't draw. The TAKI sequences the TAKI cards open are closed.
+ * Receives a pointer to the context and the number of cards to drop.
+ */
+void Bench_Try_Play_Card(BENCH_CONTEXT* context_p, long long nof_ops)
+{
+    GAME_DATA* game_data_p = &context_p->game_data; // The benchmarks' game.
+    PLAYER* player_p = &game_data_p->players[0]; // The player who drops the cards.
+
+    Bench_Fill_Hand(context_p, 64);
+
+    for (long long op_i = 0; op_i < nof_ops; op_i++)
+    {
+        int input_i = (int) (op_i & (BENCH_NOF_INPUTS - 1)); // The card to drop and its top card.
+
+        game_data_p->top_card = context_p->top_cards[input_i];
+        game_data_p->is_taki_open = false;
+        Hand_Add(&player_p->hand, context_p->cards[input_i]);
+        context_p->sink += Try_Play_Card(game_data_p, player_p, context_p->cards[input_i], context_p->colors[input_i]);
+    }
+
+    game_data_p->is_taki_open = false;
+}
+
+
+/*
+ * Draw cards of the infinite deck into the player's hand. The hand starts empty in every repetition.
+ * Receives a pointer to the context and the number of cards to draw.
+ */
+void Bench_Draw_New_Card(BENCH_CONTEXT* context_p, long long nof_ops)
+{
+    GAME_DATA* game_data_p = &context_p->game_data; // The benchmarks' game.
+    PLAYER* player_p = &game_data_p->players[0]; // The player who draws the cards.
+
+    Hand_Init(&player_p->hand);
+
+    for (long long op_i = 0; op_i < nof_ops; op_i++)
+        Draw_New_Card(game_data_p, player_p);
+
+    context_p->sink += player_p->hand.nof_cards;
+}
+
+
+/*
+ * Draw cards of the standard deck, and discard every card after it is drawn, so the deck is reshuffled whenever the draw pile ends.
+ * Receives a pointer to the context and the number of cards to draw.
+ */
+void Bench_Draw_Finite_Card(BENCH_CONTEXT* context_p, long long nof_ops)
+{
+    GAME_DATA* game_data_p = &context_p->game_data; // The benchmarks' game.
+    PLAYER* player_p = &game_data_p->players[0]; // The player who draws the cards.
+    DECK infinite_deck = game_data_p->deck; // The deck of the other benchmarks, returned at the end.
+
+    Deck_Init(&game_data_p->deck, STANDARD_DECK_COUNTS, &context_p->rng);
+    Hand_Init(&player_p->hand);
+
+    for (long long op_i = 0; op_i < nof_ops; op_i++)
+    {
+        Draw_New_Card(game_data_p, player_p);
+        Hand_Remove(&player_p->hand, game_data_p->last_drawn_card);
+        Deck_Discard(&game_data_p->deck, game_data_p->last_drawn_card);
+    }
+
+    context_p->sink += game_data_p->deck.nof_draw;
+    game_data_p->deck = infinite_deck;
+}
+
+
+/*
+ * Draw cards into a new cards array of the start size, and double the array (Reallocate_Cards_Array) whenever the cards don't fit,
+ * as Update_Cards_Array grows it. The array isn't built, Bench_Update_Cards_Array times the building.
+ * Receives a pointer to the context and the number of cards to draw, a new hand is started every BENCH_NOF_INPUTS cards.
+ */
+void Bench_Cards_Array_Growth(BENCH_CONTEXT* context_p, long long nof_ops)
+{
+    GAME_DATA* game_data_p = &context_p->game_data; // The benchmarks' game.
+    PLAYER* player_p = &game_data_p->players[0]; // The player who draws the cards.
+
+    for (long long op_i = 0; op_i < nof_ops; op_i++)
+    {
+        // Start a new hand with a new cards array of the start size.
+        if (op_i % BENCH_NOF_INPUTS == 0)
+        {
+            Hand_Init(&player_p->hand);
+            Reallocate_Cards_Array(game_data_p, player_p, NOF_START_CARDS);
+        }
+
+        Draw_New_Card(game_data_p, player_p);
+        if (player_p->hand.nof_cards > player_p->cards_phys_size)
+            Reallocate_Cards_Array(game_data_p, player_p, 2 * player_p->cards_phys_size);
+    }
+
+    context_p->sink += player_p->cards_phys_size;
+}
+
+
+/*
+ * Remove a card from a hand of the context's hand size, and add it back.
+ * Receives a pointer to the context and the number of cards to remove.
+ */
+void Bench_Hand_Remove(BENCH_CONTEXT* context_p, long long nof_ops)
+{
+    PLAYER* player_p = &context_p->game_data.players[0]; // The player whose cards are removed.
+
+    Bench_Fill_Hand(context_p, context_p->hand_size);
+
+    for (long long op_i = 0; op_i < nof_ops; op_i++)
+    {
+        CARD card = player_p->cards[op_i % context_p->hand_size]; // A card of the hand.
+
+        Hand_Remove(&player_p->hand, card);
+        Hand_Add(&player_p->hand, card);
+    }
+
+    context_p->sink += player_p->hand.nof_cards;
+}
+
+
+/*
+ * Build the printed cards array of a hand of the context's hand size again, as after every change of the hand.
+ * Receives a pointer to the context and the number of times to build it.
+ */
+void Bench_Update_Cards_Array(BENCH_CONTEXT* context_p, long long nof_ops)
+{
+    PLAYER* player_p = &context_p->game_data.players[0]; // The player whose cards are built.
+
+    Bench_Fill_Hand(context_p, context_p->hand_size);
+
+    for (long long op_i = 0; op_i < nof_ops; op_i++)
+    {
+        player_p->is_cards_array_updated = false;
+        Update_Cards_Array(&context_p->game_data, player_p);
+        context_p->sink += player_p->cards[op_i % context_p->hand_size];
+    }
+}
+
+
+/*
+ * Sort a copy of the unsorted stats.
+ * Receives a pointer to the context and the number of sorts.
+ */
+void Bench_Sort_Stats_Array(BENCH_CONTEXT* context_p, long long nof_ops)
+{
+    STAT_DATA stats[GAME_STATS_MAX_SIZE]; // The copy that is sorted.
+
+    for (long long op_i = 0; op_i < nof_ops; op_i++)
+    {
+        memcpy(stats, context_p->stats, sizeof(STAT_DATA) * context_p->nof_stats);
+        Sort_Stats_Array(stats, context_p->nof_stats);
+        context_p->sink += stats[0].card_freq;
+    }
+}
+
+
+/*
+ * Play full games of 4 automatic players with the standard deck, as the simulation plays them.
+ * Receives a pointer to the context and the number of games. Every game has its own stream, the same in every repetition.
+ */
+void Bench_Full_Games(BENCH_CONTEXT* context_p, long long nof_ops)
+{
+    GAME_DATA game_data; // The game being played.
+
+    for (long long op_i = 0; op_i < nof_ops; op_i++)
+    {
+        Engine_Init_Game(&game_data, 4, BENCH_SEED, (uint64_t) op_i, STANDARD_DECK_COUNTS, &context_p->arena);
+        context_p->sink += Engine_Play_Game(&game_data, Choose_Auto_Move, NULL);
+        Engine_Free_Game(&game_data);
+        Arena_Reset(&context_p->arena);
+    }
+}
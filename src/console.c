@@ -0,0 +1,560 @@
+#include "header.h"
+
+// ---------------------- Print Functions -----------------------
+
+/*
+ * Print Welcome Message.
+ */
+void Print_Welcome_Screen()
+{
+    printf("************  Welcome to TAKI game !!! ***********\n");
+}
+
+
+/*
+ * Prints the received card's info into a frame.
+ * The card is copied from the glyph cache, every card code is drawn only once.
+ */
+void Print_Card(FRAME* frame_p, CARD card)
+{
+    const CARD_GLYPH* glyph_p = Get_Card_Glyph(card); // The drawing of the card.
+
+    // Print each row of the card, and go down a line for the next row to start.
+    for (int row = 0; row < CARD_LENGTH; row++)
+    {
+        Frame_Append(frame_p, glyph_p->rows[row], CARD_WIDTH);
+        Frame_Put_Char(frame_p, '\n');
+    }
+}
+
+
+/*
+ * Draws the received card's info into a glyph.
+ * Checks whether the card is a normal card or special card,
+ * Calls for the right draw function that will draw the card.
+ */
+void Draw_Card_Glyph(CARD_GLYPH* glyph_p, CARD card)
+{
+    // Check if the card is a NORMAL card.
+    if (Get_Card_Type(card) == TYPE_NORMAL)
+        Draw_Normal_Card(glyph_p, card); // The card type is NORMAL, then draws with the normal cards functions.
+    else
+        Draw_Special_Card(glyph_p, card); // The card type isn't NORMAL (the type is one of the special cards), then draws with the special cards functions.
+}
+
+
+/*
+ * Draws a normal card- containing a number from 1-9 and a color (green/red/yellow/blue).
+ * Each color is represented by the first character of its name (G/R/Y/B).
+ * Receives the glyph to draw into, and a card containing a card number and a color in the correct format.
+ */
+void Draw_Normal_Card(CARD_GLYPH* glyph_p, CARD card)
+{
+    int num = Get_Card_Num(card); // Get the card's number.
+    char color = Get_Color_Char(Get_Card_Color(card)); // Get the character of the card's color.
+
+    // For each row of the card.
+    for (int row = 0; row < CARD_LENGTH; row++)
+    {
+        // For each collum of that row.
+        for (int col = 0; col < CARD_WIDTH; col++)
+        {
+            char* cell_p = &glyph_p->rows[row][col]; // The character of the current collum.
+
+            // If reached the top or bottom sections of the card, draws the border with '*' and continue to the next collum.
+            if (row == 0 || row == CARD_LENGTH - 1) { *cell_p = CARD_BORDER[0]; continue; }
+
+            // If reached the left or right borders of the card, draws the border with '*' and continue to the next collum.
+            if (col == 0 || col == CARD_WIDTH - 1) { *cell_p = CARD_BORDER[0]; continue; }
+
+            // Check if the current collum is in the middle of the card.
+            if (col == CARD_WIDTH / 2)
+            {
+                // The card length is an even number so there are 2 rows in the middle- first row for the number, second row for the color.
+                // Check if in the right row for the number of the card.
+                if (row == CARD_LENGTH / 2 - 1)
+                    *cell_p = (char) ('0' + num); // Draw the card number
+                else // Not in the first middle row.
+                {
+                    // Check if in the right row for the color of the card.
+                    if (row == CARD_LENGTH / 2)
+                        *cell_p = color; // Draw the color's character.
+                    else // Not in the second middle row.
+                        *cell_p = ' '; // Draw an empty space.
+                }
+            }
+            else // Not in the middle collum.
+                *cell_p = ' '; // Draw an empty space.
+        }
+    }
+}
+
+
+/*
+ * Draws a special card- containing the type: "+" / "STOP" / "<->" / "COLOR" / "TAKI" , and a color: green / red / yellow / blue.
+ * Each color is represented by the first character of its name (G/R/Y/B).
+ * Receives the glyph to draw into, and a card containing its type and color.
+ */
+void Draw_Special_Card(CARD_GLYPH* glyph_p, CARD card)
+{
+    const char* type_name = CARD_TYPE_NAMES[Get_Card_Type(card)]; // The string of the card's type, drawn in the middle of the card.
+    int card_mid = CARD_WIDTH / 2, card_type_mid = Find_Str_Mid_Index(type_name); // Get the card's width middle and the card's type string middle.
+    int print_index = card_mid - card_type_mid; // The collum index where the card's type will be drawn. Set the start index depending on the card's width and type string.
+    int type_index = 0; // The index of the type's character that needs to be drawn.
+
+    // For each row of the card.
+    for (int row = 0; row < CARD_LENGTH; row++)
+    {
+        // For each collum of that row.
+        for (int col = 0; col < CARD_WIDTH; col++)
+        {
+            char* cell_p = &glyph_p->rows[row][col]; // The character of the current collum.
+
+            // If reached the top or bottom sections of the card, draws the border with the card border character and continue to the next collum.
+            if (row == 0 || row == CARD_LENGTH - 1) { *cell_p = CARD_BORDER[0]; continue; }
+
+            // If reached the left or right borders of the card, draws the border with the card border character and continue to the next collum.
+            if (col == 0 || col == CARD_WIDTH - 1) { *cell_p = CARD_BORDER[0]; continue; }
+
+            // Check if in the right row for the type name.
+            if (row == CARD_LENGTH / 2 - 1)
+            {
+                // Check if the current collum is in the location to draw the type name, and if there are still characters in the type's name that weren't drawn.
+                if (col == print_index && type_name[type_index] != '\0')
+                {
+                    // Draw the character of type name in the current index.
+                    *cell_p = type_name[type_index];
+                    type_index++; // Move to the next index in the type name.
+                    print_index++; // Move to the index of the next collum where the next type name character will be drawn.
+                }
+                else // The collum is not in the correct place or the type name was drawn completely.
+                    *cell_p = ' '; // Draw an empty space.
+
+                continue; // Continue to the next collum.
+            }
+
+            // Check if the current collum is in the middle of the card where the color character will be drawn.
+            if (col == CARD_WIDTH / 2 && row == CARD_LENGTH / 2)
+                *cell_p = Get_Color_Char(Get_Card_Color(card)); // Draw the color's character.
+            else // Not in the correct location for the color.
+                *cell_p = ' '; // Draw an empty space.
+        }
+    }
+}
+
+
+/*
+ * Prints all the cards the player has into a frame, side by side in rows that fit the width of the screen.
+ * Every card has its number above it (which is the index+1 because indexes starts at 0 and our count starts at 1).
+ * Receives the frame to print into, and a pointer to the player whose cards should be printed, the player's cards array needs to be updated (Update_Cards_Array).
+ */
+void Print_Player_Cards(FRAME* frame_p, const PLAYER* player_p)
+{
+    int nof_cols = (Get_Screen_Width() + CARD_GAP) / (CARD_WIDTH + CARD_GAP); // How many cards fit side by side.
+
+    if (nof_cols < 1)
+        nof_cols = 1;
+
+    // For each row of cards.
+    for (int first_i = 0; first_i < player_p->hand.nof_cards; first_i += nof_cols)
+    {
+        int end_i = first_i + nof_cols < player_p->hand.nof_cards ? first_i + nof_cols : player_p->hand.nof_cards; // The card after the last card of the row.
+
+        // Print the number of every card in the row, each above its card.
+        Frame_Put_Char(frame_p, '\n');
+        for (int card_i = first_i; card_i < end_i; card_i++)
+        {
+            char label[MAX_LABEL_LEN]; // The number of the card, as it is printed.
+
+            snprintf(label, sizeof(label), "Card #%d", card_i + 1);
+            if (card_i > first_i)
+                Frame_Printf(frame_p, "%*s", CARD_GAP, ""); // The space between the cards.
+            Frame_Printf(frame_p, "%-*s", card_i + 1 < end_i ? CARD_WIDTH : 0, label); // The last number of the line isn't padded.
+        }
+        Frame_Put_Char(frame_p, '\n');
+
+        // Print each line of the cards of the row.
+        for (int line = 0; line < CARD_LENGTH; line++)
+        {
+            for (int card_i = first_i; card_i < end_i; card_i++)
+            {
+                if (card_i > first_i)
+                    Frame_Printf(frame_p, "%*s", CARD_GAP, ""); // The space between the cards.
+                Frame_Append(frame_p, Get_Card_Glyph(player_p->cards[card_i])->rows[line], CARD_WIDTH);
+            }
+            Frame_Put_Char(frame_p, '\n');
+        }
+    }
+}
+
+
+/*
+ * Prints the current top card of the deck, the player's name whose turn it is and all of his cards.
+ * The whole screen is composed in one frame, and written with a single write.
+ * Receives the top card and a pointer to the player whose cards needs printing.
+ */
+void Print_Current_Deck(CARD top_card, const PLAYER* player_p)
+{
+    FRAME frame; // The screen of the turn.
+
+    Frame_Init(&frame);
+
+    // Print the card on top of the deck.
+    Frame_Put_Str(&frame, "\nUpper card:\n");
+    Print_Card(&frame, top_card); // Print the top card.
+
+    // Print the name of the player currently playing.
+    Frame_Printf(&frame, "\n%s's turn:\n", player_p->name);
+
+    // Print all the cards the player has.
+    Print_Player_Cards(&frame, player_p);
+
+    Frame_Flush(&frame); // Write the screen.
+}
+
+
+/*
+ * Prints special card stats line.
+ * Receives the stat wanted to be printed.
+ */
+void Print_Special_Card_Stat(STAT_DATA stat)
+{
+    const char* type_name = CARD_TYPE_NAMES[stat.card_type]; // The string of the card's type.
+    int type_i = 0; // The index of the type's string.
+    int print_i = COL_LEN/2 - Find_Str_Mid_Index(type_name); // The index where the type's string needs to start from. Starts from the middle of the collum minus the mid of the card's name.
+    int line_i = 0; // The index of the character in the line.
+
+    // While the line index didn't go past the length of the collum.
+    while (line_i < COL_LEN)
+    {
+        // Check if the line index is smaller than the index where the card type will be printed, or the card type was fully printed already.
+        if (line_i < print_i || type_name[type_i] == '\0')
+            printf(" "); // Print a space.
+        else // Print the card type's string.
+            {
+                printf("%c", type_name[type_i]); // Print the character in the type index.
+                type_i++; // Move to the next index in the type's string.
+                print_i++; // Move to the next print index.
+            }
+        line_i++; // Move to the next character in the line.
+    }
+    // Print the card frequency.
+    printf("|    %llu\n", stat.card_freq);
+}
+
+
+/*
+ * Print the statistics of how many times each card in the game was drawn.
+ * Receives a pointer to the game's data which contains the cards frequency table.
+ */
+void Print_Game_Stats(const GAME_DATA* game_data_p)
+{
+    Print_Card_Stats(game_data_p->card_freqs);
+}
+
+
+/*
+ * Print the statistics of how many times each card was drawn, from the card with the highest frequency to the lowest.
+ * Receives the frequency table of the card codes. The stats are built from it and sorted only here, when they are printed.
+ */
+void Print_Card_Stats(const unsigned long long card_freqs[])
+{
+    STAT_DATA stats[GAME_STATS_MAX_SIZE]; // The stats of every card that was drawn.
+    int nof_stats = Build_Stats_View(card_freqs, stats); // The number of stats in the stats array.
+
+    // Sort the stats by the frequency of the cards.
+    Sort_Stats_Array(stats, nof_stats);
+
+    // Print title.
+    printf("\n************ Game Statistics ************\n");
+    printf("Card # | Frequency\n__________________\n");
+
+    // For every stat in the stats array.
+    for (int stat_i = 0; stat_i < nof_stats; stat_i++)
+    {
+        // Check if the card's type is NORMAL, if not then it's a special card. sends to the right print function accordingly.
+        if (stats[stat_i].card_type == TYPE_NORMAL)
+            printf("   %d   |    %llu\n", stats[stat_i].card_num, stats[stat_i].card_freq); // Print normal card.
+        else
+            Print_Special_Card_Stat(stats[stat_i]); // Print special card.
+    }
+}
+
+
+
+// ------------------ Game Setup Functions --------------------
+
+/*
+ * Receives number of players variable's address.
+ * Sets value from user input.
+ */
+void Set_Nof_Players(int* nof_players)
+{
+    printf("Please enter the number of players:\n");
+    scanf("%d", nof_players);
+}
+
+
+/*
+ * Set the players' names from user input.
+ * Receives players array, and the number of players in the game.
+ * The maximum length of each name is MAX_NAME_LEN.
+ */
+void Set_Players_Names(PLAYER players[], int nof_players)
+{
+    // For each player in players array.
+    for(int i = 1; i <= nof_players; i++)
+    {
+        // Request and set name input for current player.
+        printf("Please enter the first name of player #%d:\n", i);
+        scanf("%s", players[i - 1].name);
+
+        // The computer plays the players named AI_PLAYER_NAME.
+        players[i - 1].is_computer = !strcmp(players[i - 1].name, AI_PLAYER_NAME);
+    }
+}
+
+
+
+// -------------------- Gameplay Functions --------------------
+
+/*
+ * Start playing the game.
+ * Every move is chosen by the players from the keyboard, or by the computer for the computer's players, and applied by the engine.
+ * Receives a pointer to the game's data, the full screen mode's TUI (NULL to print the cards as lines) and the AI (NULL if no player is the computer's).
+ */
+void Play_Game(GAME_DATA* game_data_p, TUI* tui_p, AI_PLAYER* ai_p)
+{
+    // Play until one of the players has dropped all his cards.
+    while (!game_data_p->is_game_won)
+    {
+        PLAYER* player_p = &game_data_p->players[game_data_p->player_index]; // The player that is currently playing.
+
+        // Let the computer choose, and show what it chose. (its cards aren't shown)
+        if (player_p->is_computer && ai_p != NULL)
+        {
+            MOVE move = Choose_Ai_Move(game_data_p, ai_p); // The computer's move.
+
+            Print_Computer_Move(game_data_p, move);
+            Engine_Apply_Move(game_data_p, move);
+            continue;
+        }
+
+        // Build the printed cards of the player that is currently playing, and apply his choice. (the choice is always legal)
+        Update_Cards_Array(game_data_p, player_p);
+        Engine_Apply_Move(game_data_p, Choose_Human_Move(game_data_p, tui_p));
+    }
+
+    // Print the finished game message with the winner's name.
+    Check_Winner(&game_data_p->players[game_data_p->winner_index]);
+}
+
+
+/*
+ * Print the move the computer chose for the current player.
+ * Receives a pointer to the game's data, before the move is applied, and the move.
+ */
+void Print_Computer_Move(const GAME_DATA* game_data_p, MOVE move)
+{
+    const char* name = game_data_p->players[game_data_p->player_index].name; // The name of the computer's player.
+
+    switch (move.kind)
+    {
+        case MOVE_DRAW:
+            printf("%s took a card from the deck.\n", name);
+            break;
+
+        case MOVE_END_TAKI:
+            printf("%s finished the TAKI sequence.\n", name);
+            break;
+
+        case MOVE_PLAY:
+            if (Get_Card_Type(move.card) == TYPE_NORMAL)
+                printf("%s put the card %d %c.\n", name, Get_Card_Num(move.card), Get_Color_Char(Get_Card_Color(move.card)));
+            else if (Get_Card_Type(move.card) == TYPE_COLOR && !game_data_p->is_taki_open)
+                printf("%s put the card %s and chose %c.\n", name, CARD_TYPE_NAMES[TYPE_COLOR], Get_Color_Char(move.color));
+            else
+                printf("%s put the card %s %c.\n", name, CARD_TYPE_NAMES[Get_Card_Type(move.card)], Get_Color_Char(Get_Card_Color(move.card)));
+            break;
+    }
+}
+
+
+/*
+ * Lets the current player choose his next move from the keyboard.
+ * Prints the current top card, the player's name and all of his cards, then keeps requesting a choice until a valid move is entered.
+ * The cards are chosen by their number in the printed cards, the player's cards array needs to be updated (Update_Cards_Array).
+ * Receives a pointer to the game's data and the context pointer (matches CHOOSE_MOVE_FUNC): the full screen mode's TUI, or NULL to print the cards as lines.
+ * Returns the chosen move.
+ */
+MOVE Choose_Human_Move(const GAME_DATA* game_data_p, void* context_p)
+{
+    const PLAYER* player_p = &game_data_p->players[game_data_p->player_index]; // The player that is currently playing.
+    TUI* tui_p = (TUI*) context_p; // The full screen mode, NULL if it is off.
+    int card_chosen; // The number of the card wished to be played. If 0, then draw a new card or end the TAKI sequence.
+    MOVE move; // The result move.
+
+    // Print the current top card, the player's name and the player's cards.
+    if (tui_p != NULL)
+        Tui_Draw_Deck(tui_p, game_data_p->top_card, player_p); // Update only the changes of the screen.
+    else
+        Print_Current_Deck(game_data_p->top_card, player_p);
+
+    // Until the player entered a valid input, keeps requesting for a card choice.
+    while (true)
+    {
+        // Print request message for what play the player wants to do. 0: Draw a card from the deck (or finish the TAKI sequence), 1 to number of cards: Drop a card the player has.
+        if (game_data_p->is_taki_open)
+            printf("Please enter 0 if you want to finish your turn\nor 1-%d if you want to put one of your cards in the middle:\n", player_p->hand.nof_cards);
+        else
+            printf("Please enter 0 if you want to take a card from the deck\nor 1-%d if you want to put one of your cards in the middle:\n", player_p->hand.nof_cards);
+
+        // Get the input for the card chosen. Stop the game if the input has ended.
+        if (scanf("%d", &card_chosen) != 1)
+            exit(0);
+
+        if (card_chosen == 0)
+            move.kind = game_data_p->is_taki_open ? MOVE_END_TAKI : MOVE_DRAW; // Draw a card, or finish the TAKI sequence.
+        else
+        {
+            // Check if the player entered a card number he doesn't have.
+            if (card_chosen < 1 || card_chosen > player_p->hand.nof_cards) { printf("Invalid card! Try again.\n"); continue; }
+
+            move.kind = MOVE_PLAY;
+            move.card = player_p->cards[card_chosen - 1]; // The indexes start at 0 while our count starts at 1.
+            move.color = COLOR_NONE;
+
+            // Check if the player wants to drop a COLOR card that needs a color. (inside a TAKI sequence it takes the color of the top card)
+            if (!game_data_p->is_taki_open && Get_Card_Type(move.card) == TYPE_COLOR)
+                move.color = Get_Color_Choice(); // Let the player choose the color of the card.
+        }
+
+        // Check if the move can be played.
+        if (Engine_Is_Legal_Move(game_data_p, move))
+            return move;
+
+        // A card can't be dropped, the player entered a wrong input and will be requested for a new input in a new loop sequence.
+        printf("Invalid card! Try again.\n"); // Print wrong input message.
+    }
+}
+
+
+/*
+ * Lets the player choose what color the COLOR card will be.
+ * Returns the wanted color, or COLOR_NONE if the choice is not one of the menu's colors.
+ */
+CARD_COLOR Get_Color_Choice()
+{
+    int color_choice; // The menu choice for the color of the card.
+
+    // Request a color for the card from the player.
+    printf("Please enter your color choice:\n1 - Yellow\n2 - Red\n3 - Blue\n4 - Green\n");
+    scanf("%d", &color_choice); // Get the color's number.
+
+    // The menu numbers are the same as the CARD_COLOR values.
+    if (!Is_Valid_Color((CARD_COLOR) color_choice))
+        return COLOR_NONE;
+
+    return (CARD_COLOR) color_choice;
+}
+
+
+
+/*
+ * Checks if the player dropped all his cards,
+ * Prints the winners name and ends the program. The game is finished.
+ * Returns true if the player won, and false if he didn't.
+ * Receives a pointer to the player to be checked.
+ */
+bool Check_Winner(const PLAYER* player_p)
+{
+    // Check if the player dropped all of his cards, if so then the game is finished and the player has won.
+    if (player_p->hand.nof_cards == 0)
+    {
+        // Game Finished!!!
+        // Print the finished game message with the winner's name.
+        printf("\nThe winner is... %s! Congratulations!\n", player_p->name);
+
+        return true; // The player has won, returns true.
+    }
+    return false; // The player didn't win, returns false.
+}
+
+
+
+/*
+ * Find the middle index of a string.
+ * Receives a string to find its middle index.
+ * If the string's length is an even number, the middle index will be to the left of the exact middle location.
+ * Else, the string length is an odd number, so the middle index is the exact middle location.
+ * Returns the result index.
+ * (This function picks the LEFT index from the exact middle in even length strings)
+ */
+int Find_Str_Mid_Index(const char str[])
+{
+    int i = 0; // The index of the current character in the string.
+    int len = 0; // The count of the length of the string.
+
+    // Count the length of the string.
+    while (str[i] != '\0')
+    {
+        len++; // Add 1 to the length.
+        i++; // Move to the next index in the string.
+    }
+
+    // Check if the length of the string is an even number.
+    if (len % 2 == 0)
+        return len / 2 - 1; // It's an even number, the middle index will be the number to the left of the exact middle.
+    else
+        return len / 2; // It's an odd number, so the middle index is that exact number.
+}
+
+
+/*
+ * Find the middle index of a string.
+ * Receives a string to find its middle index.
+ * If the string's length is an even number, the middle index will be to the right of the exact middle location.
+ * Else, the string length is an odd number, so the middle index is the exact middle location.
+ * Returns the result index.
+ * (This function picks the RIGHT index from the exact middle in even length strings)
+ */
+int Find_Str_Mid_Index2(char str[])
+{
+    int i = 0; // The index of the current character in the string.
+    int len = 0; // The count of the length of the string.
+
+    // Count the length of the string.
+    while (str[i] != '\0')
+    {
+        len++; // Add 1 to the length.
+        i++; // Move to the next index in the string.
+    }
+
+    return len / 2; // Return the middle index of the length of the string.
+}
+
+
+/*
+ * Receives a color number between 0 and 4 (CARD_COLOR), returns the correct color char.
+ */
+char Get_Color_Char(int color_num)
+{
+    // Check the received color number from 0 to 4. Chose the card's color depending on what number was received.
+    switch (color_num)
+    {
+        case 0: // The color number received is 0, a COLOR card without a chosen color.
+            return NO_COLOR; // Set the card's color to NO_COLOR (' ')
+        case 1: // The color number received is 1.
+            return YELLOW; // Set the card's color to YELLOW ('Y')
+        case 2: // The color number received is 2.
+            return RED; // Set the card's color to RED ('R')
+        case 3: // The color number received is 3.
+            return BLUE; // Set the card's color to BLUE ('B')
+        case 4: // The color number received is 4.
+            return GREEN; // Set the card's color to GREEN ('G')
+        default:
+            printf("ERROR: INVALID NUMBER RECEIVED!"); // If the function received invalid input.
+
+    }
+    return ERROR; // If for some reason the function received a wrong input color number, return error value.
+}
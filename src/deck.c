@@ -0,0 +1,170 @@
+#include "header.h"
+
+// -------------------- Deck Functions ---------------------
+// A finite deck: every card is in the draw pile, in a player's hand, on the top of the deck or in the discard pile.
+// The draw pile and the discard pile share one array inside the deck, the draw pile at its start and the discard pile at its end.
+// When the draw pile is empty, the discard pile is moved to the start of the array and shuffled into a new draw pile.
+
+// The standard deck, how many cards of every card code it has: 2 of every normal card, 2 of every colored special card and 4 COLOR cards (108 cards).
+const unsigned char STANDARD_DECK_COUNTS[NOF_CARD_CODES] =
+{
+    // Normal cards.
+    2, 2, 2, 2, 2, 2, 2, 2, 2,   2, 2, 2, 2, 2, 2, 2, 2, 2,   2, 2, 2, 2, 2, 2, 2, 2, 2,   2, 2, 2, 2, 2, 2, 2, 2, 2,
+    // Colored special cards: "+" / "STOP" / "<->" / "TAKI".
+    2, 2, 2, 2,   2, 2, 2, 2,   2, 2, 2, 2,   2, 2, 2, 2,
+    // COLOR cards, only without a color.
+    4, 0, 0, 0, 0
+};
+
+
+/*
+ * Initialize the deck of a game and shuffle its draw pile.
+ * Receives a pointer to the deck, how many cards of every card code the deck has (NULL for an infinite deck of random cards),
+ * and a pointer to the game's random numbers generator.
+ * A COLOR card in the deck has no color, the counts of the COLOR cards with a color are ignored.
+ * If the deck has more than MAX_DECK_SIZE cards, prints error message and ends the program.
+ */
+void Deck_Init(DECK* deck_p, const unsigned char deck_counts[], RNG* rng_p)
+{
+    deck_p->nof_draw = 0;
+    deck_p->nof_discard = 0;
+    deck_p->is_finite = (deck_counts != NULL);
+    deck_p->counts = deck_counts;
+
+    if (!deck_p->is_finite)
+        return; // Cards are taken with Take_Random_Card.
+
+    // Put all the cards of the deck in the draw pile.
+    for (int card = 0; card <= FIRST_COLOR_CODE; card++)
+    {
+        // Check if the deck is too big.
+        if (deck_p->nof_draw + deck_counts[card] > MAX_DECK_SIZE)
+        {
+            printf("The deck has more than %d cards!!!\n", MAX_DECK_SIZE);
+            exit(1); // Stop the program.
+        }
+
+        for (int copy_i = 0; copy_i < deck_counts[card]; copy_i++)
+            deck_p->cards[deck_p->nof_draw++] = (CARD) card;
+    }
+
+    Shuffle_Cards(deck_p->cards, deck_p->nof_draw, rng_p);
+}
+
+
+/*
+ * Draw the card on the top of the draw pile.
+ * If the draw pile is empty, the discard pile is shuffled into a new draw pile first.
+ * Receives a pointer to the deck, a pointer to the game's random numbers generator and a pointer where the card will be saved.
+ * Returns true if a card was drawn, false if all the cards of the deck are in the players' hands and on the top of the deck.
+ */
+bool Deck_Draw(DECK* deck_p, RNG* rng_p, CARD* result_card_p)
+{
+    // Check if the draw pile is empty, then make a new draw pile from the discard pile.
+    if (deck_p->nof_draw == 0)
+    {
+        if (deck_p->nof_discard == 0)
+            return false; // There are no cards to draw.
+
+        Deck_Reshuffle(deck_p, rng_p);
+    }
+
+    *result_card_p = deck_p->cards[--deck_p->nof_draw]; // Take the card from the top of the draw pile.
+    return true;
+}
+
+
+/*
+ * Draw the first normal card of the draw pile, for the first top card of the game.
+ * The special cards above it stay in the draw pile, in the same place.
+ * Receives a pointer to the deck, a pointer to the game's random numbers generator and a pointer where the card will be saved.
+ * Returns true if a normal card was drawn, false if the draw pile has no normal cards.
+ */
+bool Deck_Draw_Normal_Card(DECK* deck_p, RNG* rng_p, CARD* result_card_p)
+{
+    // Look for a normal card from the top of the draw pile.
+    for (int card_i = deck_p->nof_draw - 1; card_i >= 0; card_i--)
+    {
+        if (Get_Card_Type(deck_p->cards[card_i]) == TYPE_NORMAL)
+        {
+            // Swap the normal card with the card on the top of the draw pile, then draw it.
+            CARD tmp_card = deck_p->cards[card_i];
+            deck_p->cards[card_i] = deck_p->cards[deck_p->nof_draw - 1];
+            deck_p->cards[deck_p->nof_draw - 1] = tmp_card;
+
+            return Deck_Draw(deck_p, rng_p, result_card_p);
+        }
+    }
+
+    return false;
+}
+
+
+/*
+ * Put a card that is no longer the top card in the discard pile.
+ * A COLOR card returns to the deck without its chosen color.
+ * Receives a pointer to the deck and the card.
+ */
+void Deck_Discard(DECK* deck_p, CARD card)
+{
+    if (Get_Card_Type(card) == TYPE_COLOR)
+        card = Make_Card(TYPE_COLOR, COLOR_NONE, EMPTY);
+
+    // The discard pile grows from the end of the array towards the draw pile. Every card of the deck has one place, so they never meet.
+    deck_p->nof_discard++;
+    deck_p->cards[DECK_ARRAY_SIZE - deck_p->nof_discard] = card;
+}
+
+
+/*
+ * Make a new draw pile from the discard pile: copy the discard pile to the start of the array and shuffle it.
+ * The deck has at most MAX_DECK_SIZE cards, so the copy doesn't overwrite the discard pile's places, and an undone move can restore it (Engine_Unmake_Move).
+ * Receives a pointer to the deck, whose draw pile is empty, and a pointer to the game's random numbers generator.
+ */
+void Deck_Reshuffle(DECK* deck_p, RNG* rng_p)
+{
+    memcpy(deck_p->cards, &deck_p->cards[DECK_ARRAY_SIZE - deck_p->nof_discard], deck_p->nof_discard);
+
+    deck_p->nof_draw = deck_p->nof_discard;
+    deck_p->nof_discard = 0;
+
+    Shuffle_Cards(deck_p->cards, deck_p->nof_draw, rng_p);
+}
+
+
+/*
+ * Shuffle an array of cards in place (Fisher-Yates).
+ * Two swaps use the same random number: the product of the two bounds is small, so one 32 bits number is split into both indexes.
+ * Receives the array of cards, its size and a pointer to the game's random numbers generator.
+ */
+void Shuffle_Cards(CARD cards[], int nof_cards, RNG* rng_p)
+{
+    int card_i = nof_cards - 1; // The last card that wasn't shuffled yet.
+
+    // Swap two cards with random cards before them on every random number.
+    for (; card_i >= 2; card_i -= 2)
+    {
+        uint64_t random = (uint64_t) Rng_Next(rng_p) * (uint32_t) (card_i + 1); // The first index is in the high 32 bits.
+        uint32_t first_j = (uint32_t) (random >> 32); // A random index from 0 to card_i.
+        uint32_t second_j = (uint32_t) (((uint64_t) (uint32_t) random * (uint32_t) card_i) >> 32); // The rest of the number gives an index from 0 to card_i - 1.
+        CARD tmp_card;
+
+        tmp_card = cards[card_i];
+        cards[card_i] = cards[first_j];
+        cards[first_j] = tmp_card;
+
+        tmp_card = cards[card_i - 1];
+        cards[card_i - 1] = cards[second_j];
+        cards[second_j] = tmp_card;
+    }
+
+    // The last swap, when the number of cards is even.
+    if (card_i == 1)
+    {
+        uint32_t j = Rng_Below(rng_p, 2); // A random index from 0 to 1.
+        CARD tmp_card = cards[1];
+
+        cards[1] = cards[j];
+        cards[j] = tmp_card;
+    }
+}
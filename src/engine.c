@@ -0,0 +1,549 @@
+#include "header.h"
+
+// ----------------- Headless Engine Functions -----------------
+// These functions run the game's rules without reading from the keyboard or printing to the screen.
+// Every decision of a player is a MOVE, given directly or chosen by a CHOOSE_MOVE_FUNC callback.
+
+/*
+ * Initialize a new game without any user input.
+ * Receives a pointer to the game's data, the number of players in the game, the seed and stream of the game's random numbers,
+ * how many cards of every card code the deck has (NULL for an infinite deck of random cards),
+ * and the arena to allocate the game's memory from (NULL to allocate it with malloc).
+ * The same seed and stream with the same moves always play the same game.
+ * Allocates the players and their cards, names the players "Player 1", "Player 2", ... and hands every player his start cards.
+ * The game's data needs to be freed with Engine_Free_Game when the game is finished.
+ */
+void Engine_Init_Game(GAME_DATA* game_data_p, int nof_players, uint64_t seed, uint64_t stream, const unsigned char deck_counts[], ARENA* arena_p)
+{
+    // Initialize the game's data.
+    Init_Game_Data(game_data_p, seed, stream, deck_counts);
+    game_data_p->nof_players = nof_players;
+    game_data_p->arena_p = arena_p;
+
+    // Allocate memory for the data of all the players, and for the arrays of each player's cards.
+    Init_Allocate_Players(game_data_p);
+    Init_Allocate_Players_Cards(game_data_p, NOF_START_CARDS);
+
+    // Give every player a default name.
+    for (int player_i = 0; player_i < nof_players; player_i++)
+        snprintf(game_data_p->players[player_i].name, MAX_NAME_LEN, "Player %d", player_i + 1);
+
+    // Give every player in the game his start cards.
+    Hand_Start_Cards(game_data_p, game_data_p->players, nof_players);
+}
+
+
+/*
+ * Free the memory allocated for the game by Engine_Init_Game.
+ * The memory allocated from an arena is freed only when the arena is reset, by the arena's owner.
+ * Receives a pointer to the game's data.
+ */
+void Engine_Free_Game(GAME_DATA* game_data_p)
+{
+    if (game_data_p->arena_p != NULL)
+    {
+        game_data_p->players = NULL;
+        return;
+    }
+
+    Free_Cards_Arrays(game_data_p->players, game_data_p->nof_players); // Free the cards arrays for all the players.
+    free(game_data_p->players); // Free the players array.
+    game_data_p->players = NULL;
+}
+
+
+/*
+ * Check if a move can be played by the current player.
+ * Receives a pointer to the game's data and the move to check.
+ * Returns true if the move is legal, false otherwise.
+ */
+bool Engine_Is_Legal_Move(const GAME_DATA* game_data_p, MOVE move)
+{
+    // No move can be played after the game is finished.
+    if (game_data_p->is_game_won)
+        return false;
+
+    switch (move.kind)
+    {
+        // A new card can be drawn only outside of a TAKI sequence.
+        case MOVE_DRAW:
+            return !game_data_p->is_taki_open;
+
+        // Only an open TAKI sequence can be closed.
+        case MOVE_END_TAKI:
+            return game_data_p->is_taki_open;
+
+        // The card needs to be in the player's hand, and to match the top card.
+        case MOVE_PLAY:
+            if (move.card >= NOF_CARD_CODES || !((Get_Legal_Plays(game_data_p) >> move.card) & 1))
+                return false;
+
+            // A COLOR card needs a valid color to be chosen for it. (inside a TAKI sequence it takes the color of the top card)
+            return game_data_p->is_taki_open || Get_Card_Type(move.card) != TYPE_COLOR || Is_Valid_Color(move.color);
+    }
+
+    return false; // Unknown move kind.
+}
+
+
+/*
+ * Find all the legal moves of the current player.
+ * Receives a pointer to the game's data, and an array for the result moves. The array needs room for MAX_LEGAL_MOVES moves.
+ * Every card code that can be dropped is listed once, no matter how many cards of it the player has.
+ * A COLOR card is listed once with the color of the top card, the caller may change the color to any other valid color.
+ * Returns the number of legal moves found.
+ */
+int Engine_Get_Legal_Moves(const GAME_DATA* game_data_p, MOVE moves[])
+{
+    uint64_t plays; // The card codes that can be dropped and weren't listed yet.
+    int nof_moves = 0; // The number of moves found.
+    MOVE move; // The move currently being listed.
+
+    if (game_data_p->is_game_won)
+        return 0;
+
+    // Every card that can be dropped.
+    move.kind = MOVE_PLAY;
+    move.color = Get_Card_Color(game_data_p->top_card);
+    for (plays = Get_Legal_Plays(game_data_p); plays != 0; plays &= plays - 1)
+    {
+        move.card = (CARD) __builtin_ctzll(plays); // The lowest card code left.
+        moves[nof_moves++] = move;
+    }
+
+    // Drawing a card, or closing the TAKI sequence, is always possible.
+    moves[nof_moves] = Engine_Default_Move(game_data_p);
+    nof_moves++;
+
+    return nof_moves;
+}
+
+
+/*
+ * Get the move that is always legal for the current player: draw a card, or close the open TAKI sequence.
+ * Receives a pointer to the game's data.
+ */
+MOVE Engine_Default_Move(const GAME_DATA* game_data_p)
+{
+    MOVE move; // The result move.
+
+    move.kind = game_data_p->is_taki_open ? MOVE_END_TAKI : MOVE_DRAW;
+    move.card = 0; // Unused.
+    move.color = COLOR_NONE;
+
+    return move;
+}
+
+
+/*
+ * Apply a move of the current player to the game.
+ * If the move finishes the player's turn, moves the turn to the next player.
+ * If the player dropped all his cards, the game is won and the winner index is set.
+ * Receives a pointer to the game's data and the move to apply.
+ * Returns true if the move was applied, false if the move is not legal (the game is not changed).
+ */
+bool Engine_Apply_Move(GAME_DATA* game_data_p, MOVE move)
+{
+    PLAYER* player_p = &game_data_p->players[game_data_p->player_index]; // The player that is currently playing.
+    int player_i = game_data_p->player_index; // The index of the player, kept because the special cards move the player index.
+
+    if (!Engine_Is_Legal_Move(game_data_p, move))
+        return false;
+
+    // Record the move before it changes the game, a COLOR card is recorded with its color only outside of a TAKI sequence.
+    if (game_data_p->log_p != NULL)
+        Log_Move(game_data_p->log_p, move, game_data_p->is_taki_open);
+
+    switch (move.kind)
+    {
+        case MOVE_DRAW:
+            Draw_New_Card(game_data_p, player_p); // Draw a random card, reallocates the memory of the cards array to fit the new card.
+            break;
+
+        case MOVE_END_TAKI:
+            Close_Taki_Sequence(game_data_p, player_p); // Use the last card dropped in the sequence.
+            break;
+
+        case MOVE_PLAY:
+            Try_Play_Card(game_data_p, player_p, move.card, move.color); // The move is legal, so the card is dropped.
+            break;
+    }
+
+    // Check if the player won the game, he dropped all of his cards.
+    if (player_p->hand.nof_cards == 0)
+    {
+        game_data_p->is_game_won = true;
+        game_data_p->winner_index = player_i;
+
+        if (game_data_p->log_p != NULL)
+            Log_End_Game(game_data_p->log_p, player_i);
+        return true;
+    }
+
+    // The turn continues while the player is in a TAKI sequence.
+    if (!game_data_p->is_taki_open)
+        Engine_Next_Turn(game_data_p);
+
+    return true;
+}
+
+
+/*
+ * Move the turn to the next player according to the game's direction.
+ * Keeps the player index between 0 and the number of players, also after STOP and PLUS cards moved it.
+ * Receives a pointer to the game's data.
+ */
+void Engine_Next_Turn(GAME_DATA* game_data_p)
+{
+    int nof_players = game_data_p->nof_players; // The number of players in the game.
+
+    // Check the direction of the game and move the index accordingly.
+    if (game_data_p->is_direction_right)
+        game_data_p->player_index++; // Move index to the right.
+    else
+        game_data_p->player_index--; // Move index to the left.
+
+    // Restart from the first/last player after a full revolution of turns.
+    game_data_p->player_index = (game_data_p->player_index % nof_players + nof_players) % nof_players;
+}
+
+
+/*
+ * Play a full turn of the current player.
+ * Asks the choose move function for moves until the turn is finished (a TAKI sequence takes several moves).
+ * If the chosen move is not legal, the default move (draw a card or close the TAKI sequence) is played instead.
+ * Receives a pointer to the game's data, the choose move function and its context pointer.
+ * Returns true if the game continues, false if the game is won.
+ */
+bool Engine_Step_Turn(GAME_DATA* game_data_p, CHOOSE_MOVE_FUNC choose_move, void* context_p)
+{
+    do
+    {
+        // Get the player's choice, and apply it. If it can't be applied, apply the move that is always legal.
+        if (!Engine_Apply_Move(game_data_p, choose_move(game_data_p, context_p)))
+            Engine_Apply_Move(game_data_p, Engine_Default_Move(game_data_p));
+    }
+    while (game_data_p->is_taki_open && !game_data_p->is_game_won);
+
+    return !game_data_p->is_game_won;
+}
+
+
+/*
+ * Play the game until one of the players wins.
+ * Receives a pointer to the game's data, the choose move function for all the players and its context pointer.
+ * Returns the index of the winner.
+ */
+int Engine_Play_Game(GAME_DATA* game_data_p, CHOOSE_MOVE_FUNC choose_move, void* context_p)
+{
+    // Play turns while no player has dropped all his cards.
+    while (Engine_Step_Turn(game_data_p, choose_move, context_p));
+
+    return game_data_p->winner_index;
+}
+
+
+/*
+ * Get the result of the game.
+ * Receives a pointer to the game's data.
+ * Returns the index of the winner, or EMPTY if the game is not finished.
+ */
+int Engine_Get_Winner(const GAME_DATA* game_data_p)
+{
+    return game_data_p->is_game_won ? game_data_p->winner_index : EMPTY;
+}
+
+
+/*
+ * An automatic player: drops the card with the lowest card code that can be dropped, otherwise draws a card (or closes the TAKI sequence).
+ * A COLOR card takes the color of the top card.
+ * Receives a pointer to the game's data and an unused context pointer (matches CHOOSE_MOVE_FUNC).
+ */
+MOVE Choose_Auto_Move(const GAME_DATA* game_data_p, void* context_p)
+{
+    uint64_t plays = Get_Legal_Plays(game_data_p); // The card codes that can be dropped.
+    MOVE move; // The result move.
+
+    (void) context_p; // The automatic player doesn't need a context.
+
+    // Check if no card can be dropped.
+    if (plays == 0)
+        return Engine_Default_Move(game_data_p);
+
+    // Drop the lowest card code that can be dropped.
+    move.kind = MOVE_PLAY;
+    move.card = (CARD) __builtin_ctzll(plays);
+    move.color = Get_Card_Color(game_data_p->top_card);
+
+    return move;
+}
+
+
+
+
+// ------------------- Make/Unmake Functions --------------------
+// Search can play a move and take it back on a single game, instead of copying the game for every move.
+// A move changes only a few values of the game, so its undo record is small. Most of the deck's cards don't need to be saved:
+// a drawn card stays in its place in the deck's array, and a reshuffle copies the discard pile without overwriting it.
+// Only a reshuffle overwrites places that an undo needs: the places of the cards drawn before it, and the discard pile's places that the next discards reuse.
+// So both are saved in the undo log when the draw pile is empty, and kept only if the move really reshuffled the deck.
+
+/*
+ * Initialize an empty undo log. No memory is allocated until the first move is made.
+ * Receives a pointer to the undo log.
+ */
+void Undo_Log_Init(UNDO_LOG* undo_log_p)
+{
+    undo_log_p->records = NULL;
+    undo_log_p->nof_records = 0;
+    undo_log_p->records_phys_size = 0;
+    undo_log_p->saved_cards = NULL;
+    undo_log_p->nof_saved_cards = 0;
+    undo_log_p->saved_cards_phys_size = 0;
+}
+
+
+/*
+ * Free the arrays of an undo log.
+ * Receives a pointer to the undo log.
+ */
+void Undo_Log_Free(UNDO_LOG* undo_log_p)
+{
+    free(undo_log_p->records);
+    free(undo_log_p->saved_cards);
+    Undo_Log_Init(undo_log_p);
+}
+
+
+/*
+ * Make room in the undo log for one more record and its saved cards. The arrays grow by doubling when they are full.
+ * Receives a pointer to the undo log and the number of cards the record saves.
+ * If the allocation failed, prints error message and ends the program.
+ */
+void Undo_Log_Reserve(UNDO_LOG* undo_log_p, int nof_saved_cards)
+{
+    // Check if the records array is full, then double its size.
+    if (undo_log_p->nof_records == undo_log_p->records_phys_size)
+    {
+        undo_log_p->records_phys_size = undo_log_p->records_phys_size ? undo_log_p->records_phys_size * 2 : MAX_LEGAL_MOVES;
+        undo_log_p->records = (UNDO_RECORD*) realloc(undo_log_p->records, sizeof(UNDO_RECORD) * undo_log_p->records_phys_size);
+    }
+
+    // Check if the saved cards don't fit, then grow the array to fit them.
+    while (undo_log_p->nof_saved_cards + nof_saved_cards > undo_log_p->saved_cards_phys_size)
+    {
+        undo_log_p->saved_cards_phys_size = undo_log_p->saved_cards_phys_size ? undo_log_p->saved_cards_phys_size * 2 : DECK_ARRAY_SIZE;
+        undo_log_p->saved_cards = (CARD*) realloc(undo_log_p->saved_cards, undo_log_p->saved_cards_phys_size);
+    }
+
+    // Check if the allocation failed.
+    if (undo_log_p->records == NULL || (undo_log_p->saved_cards == NULL && undo_log_p->saved_cards_phys_size > 0))
+    {
+        printf("Memory allocation failed!!!\n");
+        exit(1); // Stop the program.
+    }
+}
+
+
+/*
+ * Apply a move, and add what it changed to the undo log so it can be undone with Engine_Unmake_Move.
+ * The game must not be recorded (its log is NULL), the moves undone by the search never happened.
+ * Receives a pointer to the game's data, the move and a pointer to the undo log.
+ * Returns true if the move was applied, false if it is not legal (then the game and the undo log are unchanged).
+ */
+bool Engine_Make_Move(GAME_DATA* game_data_p, MOVE move, UNDO_LOG* undo_log_p)
+{
+    DECK* deck_p = &game_data_p->deck; // The game's deck.
+    HAND* hand_p = &game_data_p->players[game_data_p->player_index].hand; // The hand of the player who moves.
+    int nof_cards = hand_p->nof_cards; // The number of cards of the player before the move.
+    int nof_draw_places = 0; // The number of places of the draw pile a reshuffle could overwrite.
+    int nof_saved_cards = 0; // The number of saved places, of the draw pile then of the discard pile.
+    UNDO_RECORD* undo_p; // The record of the move.
+
+    // A draw from an empty draw pile reshuffles the discard pile (and the old top card the move may discard) into the draw pile's places.
+    if (deck_p->is_finite && deck_p->nof_draw == 0 && deck_p->nof_discard > 0)
+    {
+        nof_draw_places = (deck_p->nof_discard < MAX_DECK_SIZE) ? deck_p->nof_discard + 1 : MAX_DECK_SIZE;
+        nof_saved_cards = nof_draw_places + deck_p->nof_discard;
+    }
+
+    Undo_Log_Reserve(undo_log_p, nof_saved_cards);
+    undo_p = &undo_log_p->records[undo_log_p->nof_records];
+
+    // Save the values the move can change.
+    undo_p->rng = game_data_p->rng;
+    undo_p->player_index = game_data_p->player_index;
+    undo_p->winner_index = game_data_p->winner_index;
+    undo_p->nof_draw = deck_p->nof_draw;
+    undo_p->nof_discard = deck_p->nof_discard;
+    undo_p->top_card = game_data_p->top_card;
+    undo_p->is_direction_right = game_data_p->is_direction_right;
+    undo_p->is_taki_open = game_data_p->is_taki_open;
+    undo_p->is_game_won = game_data_p->is_game_won;
+    undo_p->nof_saved_cards = nof_saved_cards;
+    if (nof_saved_cards > 0)
+    {
+        memcpy(&undo_log_p->saved_cards[undo_log_p->nof_saved_cards], deck_p->cards, nof_draw_places);
+        memcpy(&undo_log_p->saved_cards[undo_log_p->nof_saved_cards + nof_draw_places], &deck_p->cards[DECK_ARRAY_SIZE - deck_p->nof_discard], deck_p->nof_discard);
+    }
+
+    if (!Engine_Apply_Move(game_data_p, move))
+        return false;
+
+    // Keep the saved places of the draw pile only if the move reshuffled the deck. (only a reshuffle makes the discard pile smaller)
+    if (deck_p->nof_discard < undo_p->nof_discard)
+        undo_log_p->nof_saved_cards += nof_saved_cards;
+    else
+        undo_p->nof_saved_cards = 0;
+
+    // A card was drawn if the player has more cards than he had minus the dropped card.
+    undo_p->is_card_dropped = (move.kind == MOVE_PLAY);
+    undo_p->dropped_card = move.card;
+    undo_p->is_card_drawn = (hand_p->nof_cards > nof_cards - (undo_p->is_card_dropped ? 1 : 0));
+    undo_p->drawn_card = game_data_p->last_drawn_card;
+
+    undo_log_p->nof_records++;
+    return true;
+}
+
+
+/*
+ * Undo the last move made with Engine_Make_Move, the game returns exactly to how it was before the move.
+ * Receives a pointer to the game's data and a pointer to the undo log.
+ * Returns true if a move was undone, false if the undo log is empty.
+ */
+bool Engine_Unmake_Move(GAME_DATA* game_data_p, UNDO_LOG* undo_log_p)
+{
+    const UNDO_RECORD* undo_p; // The record of the last made move.
+    PLAYER* player_p; // The player who moved.
+
+    if (undo_log_p->nof_records == 0)
+        return false;
+
+    undo_p = &undo_log_p->records[--undo_log_p->nof_records];
+    player_p = &game_data_p->players[undo_p->player_index];
+
+    // Give back the dropped card and take back the drawn card, with its stat.
+    if (undo_p->is_card_drawn)
+    {
+        Hand_Remove(&player_p->hand, undo_p->drawn_card);
+        game_data_p->card_freqs[undo_p->drawn_card]--;
+    }
+    if (undo_p->is_card_dropped)
+        Hand_Add(&player_p->hand, undo_p->dropped_card);
+    player_p->is_cards_array_updated = false; // The printed cards need to be built again.
+
+    // Put back the places of the piles that a reshuffle overwrote. Otherwise the cards weren't moved, only the sizes of the piles changed.
+    if (undo_p->nof_saved_cards > 0)
+    {
+        const CARD* saved_cards; // The saved places, of the draw pile then of the discard pile.
+        int nof_draw_places = undo_p->nof_saved_cards - undo_p->nof_discard; // The number of saved places of the draw pile.
+
+        undo_log_p->nof_saved_cards -= undo_p->nof_saved_cards;
+        saved_cards = &undo_log_p->saved_cards[undo_log_p->nof_saved_cards];
+        memcpy(game_data_p->deck.cards, saved_cards, nof_draw_places);
+        memcpy(&game_data_p->deck.cards[DECK_ARRAY_SIZE - undo_p->nof_discard], &saved_cards[nof_draw_places], undo_p->nof_discard);
+    }
+    game_data_p->deck.nof_draw = undo_p->nof_draw;
+    game_data_p->deck.nof_discard = undo_p->nof_discard;
+
+    game_data_p->rng = undo_p->rng;
+    game_data_p->player_index = undo_p->player_index;
+    game_data_p->winner_index = undo_p->winner_index;
+    game_data_p->top_card = undo_p->top_card;
+    game_data_p->is_direction_right = undo_p->is_direction_right;
+    game_data_p->is_taki_open = undo_p->is_taki_open;
+    game_data_p->is_game_won = undo_p->is_game_won;
+
+    return true;
+}
+
+
+
+
+// -------------------- Snapshot Functions ---------------------
+// Bots that look ahead copy the game many times for every decision. A snapshot is the whole game in one flat block,
+// the game's data followed by its players, so copying a snapshot is a single memcpy and never allocates.
+// The players in a snapshot have no cards arrays (the printed cards), the engine uses only their hands.
+
+/*
+ * Get the size of a snapshot of a game.
+ * Receives the number of players in the game.
+ * Returns the size of the snapshot in bytes, the buffer of the snapshot needs to have this size.
+ */
+size_t Game_Snapshot_Size(int nof_players)
+{
+    return sizeof(GAME_SNAPSHOT) + sizeof(PLAYER) * nof_players;
+}
+
+
+/*
+ * Copy a game into a snapshot. The snapshot doesn't use the game's arena or log, moves applied to it are never recorded.
+ * Receives a pointer to the game's data and a pointer to the snapshot, of the size Game_Snapshot_Size.
+ */
+void Game_Snapshot(const GAME_DATA* game_data_p, GAME_SNAPSHOT* snapshot_p)
+{
+    memcpy(&snapshot_p->game_data, game_data_p, sizeof(GAME_DATA));
+    memcpy(snapshot_p->players, game_data_p->players, sizeof(PLAYER) * game_data_p->nof_players);
+
+    // Keep no pointers in the snapshot, the players pointer is set when the snapshot is opened.
+    snapshot_p->game_data.players = NULL;
+    snapshot_p->game_data.arena_p = NULL;
+    snapshot_p->game_data.log_p = NULL;
+    for (int player_i = 0; player_i < game_data_p->nof_players; player_i++)
+    {
+        snapshot_p->players[player_i].cards = NULL;
+        snapshot_p->players[player_i].cards_phys_size = 0;
+        snapshot_p->players[player_i].is_cards_array_updated = false;
+    }
+}
+
+
+/*
+ * Copy a snapshot back into a game with the same number of players. The game keeps its players' names and cards arrays, its arena and its log.
+ * Receives a pointer to the game's data and a pointer to the snapshot.
+ */
+void Game_Restore(GAME_DATA* game_data_p, const GAME_SNAPSHOT* snapshot_p)
+{
+    PLAYER* players = game_data_p->players; // The game's players, kept.
+    ARENA* arena_p = game_data_p->arena_p; // The game's arena, kept.
+    GAME_LOG* log_p = game_data_p->log_p; // The game's log, kept.
+
+    memcpy(game_data_p, &snapshot_p->game_data, sizeof(GAME_DATA));
+    game_data_p->players = players;
+    game_data_p->arena_p = arena_p;
+    game_data_p->log_p = log_p;
+
+    for (int player_i = 0; player_i < game_data_p->nof_players; player_i++)
+    {
+        players[player_i].hand = snapshot_p->players[player_i].hand;
+        players[player_i].is_cards_array_updated = false; // The printed cards need to be built again.
+    }
+}
+
+
+/*
+ * Copy a snapshot into another snapshot with a single memcpy.
+ * Receives a pointer to the destination snapshot, of the size Game_Snapshot_Size, and a pointer to the source snapshot.
+ * Returns the game's data of the destination snapshot, ready to be played (Game_Snapshot_Open).
+ */
+GAME_DATA* Game_Clone(GAME_SNAPSHOT* dest_p, const GAME_SNAPSHOT* src_p)
+{
+    memcpy(dest_p, src_p, Game_Snapshot_Size(src_p->game_data.nof_players));
+
+    return Game_Snapshot_Open(dest_p);
+}
+
+
+/*
+ * Open a snapshot for playing: point its game's data to its players, so the engine functions can be used on it.
+ * The snapshot needs to be opened again after it is copied to another place.
+ * Receives a pointer to the snapshot.
+ * Returns the game's data of the snapshot. It doesn't need to be freed (Engine_Free_Game), and its cards arrays must not be built.
+ */
+GAME_DATA* Game_Snapshot_Open(GAME_SNAPSHOT* snapshot_p)
+{
+    snapshot_p->game_data.players = snapshot_p->players;
+
+    return &snapshot_p->game_data;
+}
@@ -1,273 +1,39 @@
 #include "header.h"
 
-// ---------------------- Print Functions -----------------------
-
-/*
- * Print Welcome Message.
- */
-void Print_Welcome_Screen()
-{
-    printf("************  Welcome to TAKI game !!! ***********\n");
-}
-
-
-/*
- * Prints the received card's info.
- * Checks whether the card is a normal card or special card,
- * Calls for the right print function that will print the card.
- */
-void Print_Card(CARD card)
-{
-    // Check if the card is a NORMAL card.
-    if (!strcmp(card.type, NORMAL))
-        Print_Normal_Card(card); // The card type is NORMAL, then prints with the normal cards functions.
-    else
-        Print_Special_Card(card); // The card type isn't NORMAL (the type is one of the special cards), then prints with the special cards functions.
-}
-
-
-/*
- * Prints a normal card- containing a number from 1-9 and a color (green/red/yellow/blue).
- * Each color is represented by the first character of its name (G/R/Y/B).
- * Receives a card containing a card number and a color in the correct format.
- * Prints the card.
- */
-void Print_Normal_Card(CARD card)
-{
-    int num = card.num; // Get the card's number.
-    char color = card.color; // Get the card's color.
-
-    // For each row of the card.
-    for (int row = 0; row < CARD_LENGTH; row++)
-    {
-        // For each collum of that row.
-        for (int col = 0; col < CARD_WIDTH; col++)
-        {
-            // If reached the top or bottom sections of the card, prints the border with '*' and continue to the next collum.
-            if (row == 0 || row == CARD_LENGTH - 1) { printf(CARD_BORDER); continue; }
-
-            // If reached the left or right borders of the card, prints the border with '*' and continue to the next collum.
-            if (col == 0 || col == CARD_WIDTH - 1) { printf("*"); continue; }
-
-            // Check if the current collum is in the middle of the card.
-            if (col == CARD_WIDTH / 2)
-            {
-                // The card length is an even number so there are 2 rows in the middle- first row for the number, second row for the color.
-                // Check if in the right row for the number of the card.
-                if (row == CARD_LENGTH / 2 - 1)
-                    printf("%d", num); // Print the card number
-                else // Not in the first middle row.
-                {
-                    // Check if in the right row for the color of the card.
-                    if (row == CARD_LENGTH / 2)
-                        printf("%c", color); // Print the color's character.
-                    else // Not in the second middle row.
-                        printf(" "); // Print an empty space.
-                }
-            }
-            else // Not in the middle collum.
-                printf(" "); // Print an empty space.
-        }
-    printf("\n"); // Go down a line for the next row to start.
-    }
-}
-
-
-/*
- * Prints a special card- containing the type: "+" / "STOP" / "<->" / "COLOR" / "TAKI" , and a color: green / red / yellow / blue.
- * Each color is represented by the first character of its name (G/R/Y/B).
- * Receives a card containing its type and color.
- * Prints the card.
- */
-void Print_Special_Card(CARD card)
-{
-    int card_mid = CARD_WIDTH / 2, card_type_mid = Find_Str_Mid_Index(card.type); // Get the card's width middle and the card's type string middle.
-    int print_index = card_mid - card_type_mid; // The collum index where the card's type will be printed. Set the start index depending on the card's width and type string.
-    int type_index = 0; // The index of the type's character that needs to be printed.
-
-    // For each row of the card.
-    for (int row = 0; row < CARD_LENGTH; row++)
-    {
-        // For each collum of that row.
-        for (int col = 0; col < CARD_WIDTH; col++)
-        {
-            // If reached the top or bottom sections of the card, prints the border with the card border character and continue to the next collum.
-            if (row == 0 || row == CARD_LENGTH - 1) { printf(CARD_BORDER); continue; }
-
-            // If reached the left or right borders of the card, prints the border with the card border character and continue to the next collum.
-            if (col == 0 || col == CARD_WIDTH - 1) { printf(CARD_BORDER); continue; }
-
-            // Check if in the right row for the type name.
-            if (row == CARD_LENGTH / 2 - 1)
-            {
-                // Check if the current collum is in the location to print the type name, and if there are still characters in the type's name that weren't printed.
-                if (col == print_index && card.type[type_index] != '\0')
-                {
-                    // Print the character of type name in the current index.
-                    printf("%c", card.type[type_index]);
-                    type_index++; // Move to the next index in the type name.
-                    print_index++; // Move to the index of the next collum where the next type name character will be printed.
-                }
-                else // The collum is not in the correct place or the type name was printed completely.
-                    printf(" "); // Print an empty space.
-
-                continue; // Continue to the next collum.
-            }
-
-            // Check if the current collum is in the middle of the card where the color character will be printed.
-            if (col == CARD_WIDTH / 2 && row == CARD_LENGTH / 2)
-            {
-                printf("%c", card.color); // Print the color's character.
-            }
-            else // Not in the correct location for the color.
-                printf(" "); // Print an empty space.
-        }
-        printf("\n"); // Go down a line for the next row to start.
-    }
-}
-
-
-/*
- * Prints all the cards the player has.
- * Receives the player whose cards should be printed.
- * Calls for the print card function that will call the right print function, whether the card is a normal card or the card is a special card.
- */
-void Print_Player_Cards(PLAYER player)
-{
-    // For each card the player has.
-    for (int card_i = 0; card_i < player.nof_cards; card_i++)
-    {
-        // Print the card number (which is the index+1 because indexes starts at 0 and our count starts at 1).
-        printf("\nCard #%d\n", card_i+1);
-        Print_Card(player.cards[card_i]); // Print the card.
-    }
-}
-
-
-/*
- * Prints the current top card of the deck, the player's name whose turn it is and all of his cards.
- * Receives the top card and the player whose cards needs printing.
- */
-void Print_Current_Deck(CARD top_card, PLAYER player)
-{
-    // Print the card on top of the deck.
-    printf("\nUpper card:\n");
-    Print_Card(top_card); // Print the top card.
-
-    // Print the name of the player currently playing.
-    printf("\n%s's turn:\n", player.name);
-
-    // Print all the cards the player has.
-    Print_Player_Cards(player);
-}
-
-
-/*
- * Prints special card stats line.
- * Receives the stat wanted to be printed.
- */
-void Print_Special_Card_Stat(STAT_DATA stat)
-{
-    int type_i = 0; // The index of the type's string.
-    int print_i = COL_LEN/2 - Find_Str_Mid_Index(stat.card_type); // The index where the type's string needs to start from. Starts from the middle of the collum minus the mid of the card's name.
-    int line_i = 0; // The index of the character in the line.
-
-    // While the line index didn't go past the length of the collum.
-    while (line_i < COL_LEN)
-    {
-        // Check if the line index is smaller than the index where the card type will be printed, or the card type was fully printed already.
-        if (line_i < print_i || stat.card_type[type_i] == '\0')
-            printf(" "); // Print a space.
-        else // Print the card type's string.
-            {
-                printf("%c", stat.card_type[type_i]); // Print the character in the type index.
-                type_i++; // Move to the next index in the type's string.
-                print_i++; // Move to the next print index.
-            }
-        line_i++; // Move to the next character in the line.
-    }
-    // Print the card frequency.
-    printf("|    %d\n", stat.card_freq);
-}
-
-
-/*
- * Print the statistics of how many times each card in the game was drawn.
- * Receives the game's data which contains the stats array.
- * The stats array needs to be sorted.
- */
-void Print_Game_Stats(GAME_DATA game_data)
-{
-    // Print title.
-    printf("\n************ Game Statistics ************\n");
-    printf("Card # | Frequency\n__________________\n");
-
-    // For every stat in the stats array.
-    for (int stat_i = 0; stat_i < game_data.nof_stats; stat_i++)
-    {
-        // Check if the card's type is NORMAL, if not then it's a special card. sends to the right print function accordingly.
-        if (!strcmp(game_data.stats[stat_i].card_type, NORMAL))
-            printf("   %d   |    %d\n", game_data.stats[stat_i].card_num, game_data.stats[stat_i].card_freq); // Print normal card.
-        else
-            Print_Special_Card_Stat(game_data.stats[stat_i]); // Print special card.
-    }
-}
-
-
-
 // ------------------ Game Setup Functions --------------------
 
-/*
- * Receives number of players variable's address.
- * Sets value from user input.
- */
-void Set_Nof_Players(int* nof_players)
-{
-    printf("Please enter the number of players:\n");
-    scanf("%d", nof_players);
-}
-
-
-/*
- * Set the players' names from user input.
- * Receives players array, and the number of players in the game.
- * The maximum length of each name is MAX_NAME_LEN.
- */
-void Set_Players_Names(PLAYER players[], int nof_players)
-{
-    // For each player in players array.
-    for(int i = 1; i <= nof_players; i++)
-    {
-        // Request and set name input for current player.
-        printf("Please enter the first name of player #%d:\n", i);
-        scanf("%s", players[i - 1].name);
-    }
-}
-
-
 /*
  * Initialize the game's data:
- * The starting player index, the game won status, the direction of the turns
- * and the card starting the deck of cards.
+ * The starting player index, the game won status, the direction of the turns,
+ * the random numbers generator, the deck and the card starting the deck of cards.
+ * Receives a pointer to the game's data, the seed and stream for the game's random numbers,
+ * and how many cards of every card code the deck has (NULL for an infinite deck of random cards).
  */
-void Init_Game_Data(GAME_DATA* game_data_p)
+void Init_Game_Data(GAME_DATA* game_data_p, uint64_t seed, uint64_t stream, const unsigned char deck_counts[])
 {
+    game_data_p->arena_p = NULL; // Allocate with malloc, unless an arena is set after the initialization.
     game_data_p->player_index = 0; // Initialize the index of the current player playing.
     game_data_p->is_game_won = false; // Initialize the game won to be false.
     game_data_p->is_direction_right = true; // Initialize the direction of the game to the right.
+    game_data_p->is_taki_open = false; // No TAKI sequence is open at the start of the game.
+    game_data_p->winner_index = EMPTY; // There is no winner yet.
+    game_data_p->log_p = NULL; // The game isn't recorded, unless a log is set after the initialization (Log_Begin_Game).
+    game_data_p->last_drawn_card = 0; // No card was drawn yet.
 
-    // Get a random first card in the game, sets that card on the top of the card deck.
-    Get_Random_Normal_Card(&game_data_p->top_card);
+    // Seed the game's random numbers generator. Every random card of the game comes from it.
+    game_data_p->seed = seed;
+    game_data_p->stream = stream;
+    Rng_Seed(&game_data_p->rng, seed, stream);
 
-    game_data_p->nof_stats = 0; // Initialize the game stats to the logic size of 0.
+    // Build and shuffle the deck.
+    Deck_Init(&game_data_p->deck, deck_counts, &game_data_p->rng);
 
-    // Initialize every stat is the stats array.
-    for (int i = 0; i < GAME_STATS_MAX_SIZE; i++)
-    {
-        strcpy(game_data_p->stats[i].card_type, STAT_EMPTY); // Initialize the stats' names to be "EMPTY" (when a stat will be added this value will be overwritten).
-        game_data_p->stats[i].card_num = EMPTY; // Initialize the number to be empty.
-        game_data_p->stats[i].card_freq = 0; // Initialize the card frequency;
-    }
+    // Get a random first card in the game, sets that card on the top of the card deck.
+    if (!game_data_p->deck.is_finite || !Deck_Draw_Normal_Card(&game_data_p->deck, &game_data_p->rng, &game_data_p->top_card))
+        Get_Random_Normal_Card(&game_data_p->rng, &game_data_p->top_card); // A deck without normal cards still starts with a normal card.
+
+    // Initialize the frequency of every card code.
+    memset(game_data_p->card_freqs, 0, sizeof(game_data_p->card_freqs));
 }
 
 
@@ -277,25 +43,23 @@ void Init_Game_Data(GAME_DATA* game_data_p)
  */
 void Hand_Start_Cards(GAME_DATA* game_data_p, PLAYER players[], int nof_players)
 {
-    CARD* current_card_p; // The pointer to the current card being received.
+    CARD current_card; // The current card being received.
 
     // For each player in the players array.
     for (int player_i = 0; player_i < nof_players; player_i++)
     {
-        players[player_i].nof_cards = 0; // Initialize the number of cards the player has.
+        Hand_Init(&players[player_i].hand); // Initialize the player's hand with no cards.
+        players[player_i].is_cards_array_updated = false;
 
         // Add a starting card for this player.
         for (int card_i = 0; card_i < NOF_START_CARDS; card_i++)
         {
-            current_card_p = &players[player_i].cards[card_i]; // Get the location of the card in index card_i.
-            Take_Random_Card(current_card_p); // Get a random card and insert it into the cards array, in the location of the current card.
-            players[player_i].nof_cards++; // Add one to the count of how many cards the player has.
-
-            // Check if the card received is a normal card.
-            if (!strcmp(current_card_p->type, NORMAL))
-                Check_Stat_Normal_Card(game_data_p, *current_card_p); // Add the normal card to the stats array.
-            else // The card is not a normal card, so it's a special card.
-                Check_Stat_Special_Card(game_data_p, *current_card_p); // Add the special card to the stats array.
+            // Get a card from the deck. If the deck ran out of cards, the player starts with less cards.
+            if (!Take_Card(game_data_p, &current_card))
+                return;
+
+            Hand_Add(&players[player_i].hand, current_card); // Add the card to the player's hand.
+            Add_Card_Stat(game_data_p, current_card); // Add the card to the game stats.
         }
     }
 }
@@ -309,7 +73,7 @@ void Hand_Start_Cards(GAME_DATA* game_data_p, PLAYER players[], int nof_players)
  * Initialize the allocation of the players' cards.
  * Receives a pointer to the game's data, which contains all the data for the players.
  * Receives the wanted size for the array of players' cards.
- * Allocates memory for the cards array for all the starting cards.
+ * Allocates memory for the cards array for all the starting cards, from the game's arena if it has one.
  * If the allocation failed, prints error message and ends the program.
  */
 void Init_Allocate_Players_Cards(GAME_DATA* game_data_p, int size)
@@ -318,7 +82,10 @@ void Init_Allocate_Players_Cards(GAME_DATA* game_data_p, int size)
     for (int player_i = 0; player_i < game_data_p->nof_players; player_i++)
     {
         // Try to allocate enough space for the starting cards of that player.
-        game_data_p->players[player_i].cards = (CARD *) malloc(sizeof(CARD) * size);
+        if (game_data_p->arena_p != NULL)
+            game_data_p->players[player_i].cards = (CARD *) Arena_Alloc(game_data_p->arena_p, sizeof(CARD) * size);
+        else
+            game_data_p->players[player_i].cards = (CARD *) malloc(sizeof(CARD) * size);
 
         game_data_p->players[player_i].cards_phys_size = size; // Initialize each player's cards array physical size.
 
@@ -335,13 +102,16 @@ void Init_Allocate_Players_Cards(GAME_DATA* game_data_p, int size)
 /*
  * Initialize the allocation of the players' data.
  * Receives a pointer to the game's data, where the players array is stored.
- * Allocates memory for the players' data array.
+ * Allocates memory for the players' data array, from the game's arena if it has one.
  * If the allocation failed, prints error message and ends the program.
  */
 void Init_Allocate_Players(GAME_DATA* game_data_p)
 {
     // Try to allocate enough space for all the players.
-    game_data_p->players = (PLAYER *) malloc(sizeof(PLAYER) * game_data_p->nof_players);
+    if (game_data_p->arena_p != NULL)
+        game_data_p->players = (PLAYER *) Arena_Alloc(game_data_p->arena_p, sizeof(PLAYER) * game_data_p->nof_players);
+    else
+        game_data_p->players = (PLAYER *) malloc(sizeof(PLAYER) * game_data_p->nof_players);
 
     // Check if the allocation failed.
     if (game_data_p->players == NULL)
@@ -350,31 +120,37 @@ void Init_Allocate_Players(GAME_DATA* game_data_p)
         printf("Memory allocation failed!!!\n");
         exit(1); // Stop the program.
     }
+
+    // The players are played from the keyboard, until a player is given to the computer.
+    for (int player_i = 0; player_i < game_data_p->nof_players; player_i++)
+        game_data_p->players[player_i].is_computer = false;
 }
 
 
 /*
  * Reallocates memory of an array of  cards into a new location, with the requested size.
- * Receives a pointer to the player whose cards need reallocation, and the size of the wanted new cards array.
- * Copies every card from the old location into a temporary array of cards, frees the memory previously allocated for the cards array,
- * and tries to reallocate the memory to a new location using malloc, with the size wanted.
+ * Receives a pointer to the game's data, a pointer to the player whose cards need reallocation, and the size of the wanted new cards array.
+ * If the game has an arena, grows the cards array in the arena (in place when it is the last block allocated).
+ * Otherwise frees the memory previously allocated for the cards array, and tries to reallocate the memory to a new location using malloc, with the size wanted.
+ * The cards aren't copied, the cards array is built again from the player's hand after it grows.
  * If the reallocation fails, prints error message and quits the program.
- * If the reallocation succeeded, then copies all the cards from the temp array into the new location, leaving free spots for the new cards.
  */
-void Reallocate_Cards_Array(PLAYER* player_p, int size)
+void Reallocate_Cards_Array(GAME_DATA* game_data_p, PLAYER* player_p, int size)
 {
-    int nof_cards = player_p->nof_cards; // Get the current number of cards that the player has.
-    CARD* tmp_cards = (CARD*) malloc(sizeof(CARD) * nof_cards); // A temporary array of cards that the current cards will be copied into.
-
-    // Copy every card that in the cards array into the temp array.
-    for (int card_i = 0; card_i < nof_cards; card_i++)
-        tmp_cards[card_i] = player_p->cards[card_i]; // Copy the card info into the temp array.
+    // Check if the game has an arena, then the old cards array returns to the arena when it is reset.
+    if (game_data_p->arena_p != NULL)
+    {
+        player_p->cards = (CARD*) Arena_Grow(game_data_p->arena_p, player_p->cards, sizeof(CARD) * player_p->cards_phys_size, sizeof(CARD) * size);
+        player_p->cards_phys_size = size;
+        return;
+    }
 
     // Free the memory that the malloc function allocated previously for the cards array (in the old location).
     free(player_p->cards);
 
     // Try to allocate enough space for the cards array in the new size, in a new location.
     player_p->cards = (CARD*) malloc(sizeof(CARD) * size);
+    player_p->cards_phys_size = size;
 
     // Check if the allocation failed.
     if (player_p->cards == NULL)
@@ -382,12 +158,34 @@ void Reallocate_Cards_Array(PLAYER* player_p, int size)
         printf("Memory allocation failed!!!\n");
         exit(1); // Quit with error code 1.
     }
+}
+
+
+/*
+ * Build the cards array of the player from his hand, if the hand has changed since it was last built.
+ * If the cards array is too small, reallocates it with double its size until the cards fit.
+ * Only the printing of the cards needs the array, so the games without a screen never build it.
+ * Receives a pointer to the game's data and a pointer to the player.
+ */
+void Update_Cards_Array(GAME_DATA* game_data_p, PLAYER* player_p)
+{
+    int size = player_p->cards_phys_size; // The new physical size of the cards array.
 
-    // Copy every card from the temp array into the new location that was allocated.
-    for (int card_i = 0; card_i < nof_cards; card_i++)
-        player_p->cards[card_i] = tmp_cards[card_i]; // Copy the card info into the new location.
+    // Check if the cards array is already up to date.
+    if (player_p->is_cards_array_updated)
+        return;
+
+    // Check if the cards array is full, then multiples its size by 2 until there is space for all the cards.
+    if (player_p->hand.nof_cards > size)
+    {
+        while (size < player_p->hand.nof_cards)
+            size *= 2; // Double the size of the cards array physical size.
+
+        Reallocate_Cards_Array(game_data_p, player_p, size);
+    }
 
-    free(tmp_cards); // Free memory of temporary cards array.   
+    Hand_Get_Cards(&player_p->hand, player_p->cards); // Put the cards in the order they are printed.
+    player_p->is_cards_array_updated = true;
 }
 
 
@@ -409,238 +207,204 @@ void Free_Cards_Arrays(PLAYER players[], int nof_players)
 
 
 
-// -------------------- Everything Else Functions ---------------------
+// ---------------- Card Encoding Functions -----------------
 
-/*
- * Find the middle index of a string.
- * Receives a string to find its middle index.
- * If the string's length is an even number, the middle index will be to the left of the exact middle location.
- * Else, the string length is an odd number, so the middle index is the exact middle location.
- * Returns the result index.
- * (This function picks the LEFT index from the exact middle in even length strings)
- */
-int Find_Str_Mid_Index(char str[])
+// The type, color and number of every card code, in the order described in header.h.
+const CARD_INFO CARD_INFO_TABLE[NOF_CARD_CODES] =
 {
-    int i = 0; // The index of the current character in the string.
-    int len = 0; // The count of the length of the string.
+    // Normal cards, 9 numbers for each color.
+    {TYPE_NORMAL, COLOR_YELLOW, 1}, {TYPE_NORMAL, COLOR_YELLOW, 2}, {TYPE_NORMAL, COLOR_YELLOW, 3}, {TYPE_NORMAL, COLOR_YELLOW, 4}, {TYPE_NORMAL, COLOR_YELLOW, 5},
+    {TYPE_NORMAL, COLOR_YELLOW, 6}, {TYPE_NORMAL, COLOR_YELLOW, 7}, {TYPE_NORMAL, COLOR_YELLOW, 8}, {TYPE_NORMAL, COLOR_YELLOW, 9},
+    {TYPE_NORMAL, COLOR_RED, 1}, {TYPE_NORMAL, COLOR_RED, 2}, {TYPE_NORMAL, COLOR_RED, 3}, {TYPE_NORMAL, COLOR_RED, 4}, {TYPE_NORMAL, COLOR_RED, 5},
+    {TYPE_NORMAL, COLOR_RED, 6}, {TYPE_NORMAL, COLOR_RED, 7}, {TYPE_NORMAL, COLOR_RED, 8}, {TYPE_NORMAL, COLOR_RED, 9},
+    {TYPE_NORMAL, COLOR_BLUE, 1}, {TYPE_NORMAL, COLOR_BLUE, 2}, {TYPE_NORMAL, COLOR_BLUE, 3}, {TYPE_NORMAL, COLOR_BLUE, 4}, {TYPE_NORMAL, COLOR_BLUE, 5},
+    {TYPE_NORMAL, COLOR_BLUE, 6}, {TYPE_NORMAL, COLOR_BLUE, 7}, {TYPE_NORMAL, COLOR_BLUE, 8}, {TYPE_NORMAL, COLOR_BLUE, 9},
+    {TYPE_NORMAL, COLOR_GREEN, 1}, {TYPE_NORMAL, COLOR_GREEN, 2}, {TYPE_NORMAL, COLOR_GREEN, 3}, {TYPE_NORMAL, COLOR_GREEN, 4}, {TYPE_NORMAL, COLOR_GREEN, 5},
+    {TYPE_NORMAL, COLOR_GREEN, 6}, {TYPE_NORMAL, COLOR_GREEN, 7}, {TYPE_NORMAL, COLOR_GREEN, 8}, {TYPE_NORMAL, COLOR_GREEN, 9},
+    // Colored special cards, 4 colors for each type.
+    {TYPE_PLUS, COLOR_YELLOW, EMPTY}, {TYPE_PLUS, COLOR_RED, EMPTY}, {TYPE_PLUS, COLOR_BLUE, EMPTY}, {TYPE_PLUS, COLOR_GREEN, EMPTY},
+    {TYPE_STOP, COLOR_YELLOW, EMPTY}, {TYPE_STOP, COLOR_RED, EMPTY}, {TYPE_STOP, COLOR_BLUE, EMPTY}, {TYPE_STOP, COLOR_GREEN, EMPTY},
+    {TYPE_DIRECTION, COLOR_YELLOW, EMPTY}, {TYPE_DIRECTION, COLOR_RED, EMPTY}, {TYPE_DIRECTION, COLOR_BLUE, EMPTY}, {TYPE_DIRECTION, COLOR_GREEN, EMPTY},
+    {TYPE_TAKI, COLOR_YELLOW, EMPTY}, {TYPE_TAKI, COLOR_RED, EMPTY}, {TYPE_TAKI, COLOR_BLUE, EMPTY}, {TYPE_TAKI, COLOR_GREEN, EMPTY},
+    // COLOR cards, without a color and with each chosen color.
+    {TYPE_COLOR, COLOR_NONE, EMPTY}, {TYPE_COLOR, COLOR_YELLOW, EMPTY}, {TYPE_COLOR, COLOR_RED, EMPTY}, {TYPE_COLOR, COLOR_BLUE, EMPTY}, {TYPE_COLOR, COLOR_GREEN, EMPTY}
+};
 
-    // Count the length of the string.
-    while (str[i] != '\0')
-    {
-        len++; // Add 1 to the length.
-        i++; // Move to the next index in the string.
-    }
+// The printed name of every card type, in the order of CARD_TYPE.
+const char* const CARD_TYPE_NAMES[NOF_CARD_TYPES] = { PLUS, STOP, DIRECTION, COLOR, TAKI, NORMAL };
 
-    // Check if the length of the string is an even number.
-    if (len % 2 == 0)
-        return len / 2 - 1; // It's an even number, the middle index will be the number to the left of the exact middle.
-    else
-        return len / 2; // It's an odd number, so the middle index is that exact number.
-}
+// The cards that can be dropped on a normal card: the same color or the same number. A COLOR card can be dropped on any card.
+#define NORMAL_PLAYS(color, num) (SAME_COLOR_MASK(color) | SAME_NUMBER_MASK(num) | COLOR_CARDS_MASK)
+#define NORMAL_PLAYS_ROW(color) NORMAL_PLAYS(color, 1), NORMAL_PLAYS(color, 2), NORMAL_PLAYS(color, 3), NORMAL_PLAYS(color, 4), NORMAL_PLAYS(color, 5), \
+                                NORMAL_PLAYS(color, 6), NORMAL_PLAYS(color, 7), NORMAL_PLAYS(color, 8), NORMAL_PLAYS(color, 9)
 
+// The cards that can be dropped on a colored special card: the same color or the same type.
+#define SPECIAL_PLAYS(special_i, color) (SAME_COLOR_MASK(color) | SAME_SPECIAL_MASK(special_i) | COLOR_CARDS_MASK)
+#define SPECIAL_PLAYS_ROW(special_i) SPECIAL_PLAYS(special_i, COLOR_YELLOW), SPECIAL_PLAYS(special_i, COLOR_RED), \
+                                     SPECIAL_PLAYS(special_i, COLOR_BLUE), SPECIAL_PLAYS(special_i, COLOR_GREEN)
 
-/*
- * Find the middle index of a string.
- * Receives a string to find its middle index.
- * If the string's length is an even number, the middle index will be to the right of the exact middle location.
- * Else, the string length is an odd number, so the middle index is the exact middle location.
- * Returns the result index.
- * (This function picks the RIGHT index from the exact middle in even length strings)
- */
-int Find_Str_Mid_Index2(char str[])
+// The cards that can be dropped on every top card, indexed by the top card's code. The same rules as Check_Normal_Card and Check_Special_Card.
+// The number of players doesn't change which cards can be dropped (a STOP card with 2 players changes only its effect).
+const uint64_t PLAY_MASKS[NOF_CARD_CODES] =
 {
-    int i = 0; // The index of the current character in the string.
-    int len = 0; // The count of the length of the string.
-
-    // Count the length of the string.
-    while (str[i] != '\0')
-    {
-        len++; // Add 1 to the length.
-        i++; // Move to the next index in the string.
-    }
+    // Normal cards.
+    NORMAL_PLAYS_ROW(COLOR_YELLOW), NORMAL_PLAYS_ROW(COLOR_RED), NORMAL_PLAYS_ROW(COLOR_BLUE), NORMAL_PLAYS_ROW(COLOR_GREEN),
+    // Colored special cards: "+" / "STOP" / "<->" / "TAKI".
+    SPECIAL_PLAYS_ROW(0), SPECIAL_PLAYS_ROW(1), SPECIAL_PLAYS_ROW(2), SPECIAL_PLAYS_ROW(3),
+    // COLOR cards, only the chosen color matters. (a COLOR card without a color is never the top card, and only it is in the hands)
+    COLOR_CARDS_MASK, SAME_COLOR_MASK(COLOR_YELLOW) | COLOR_CARDS_MASK, SAME_COLOR_MASK(COLOR_RED) | COLOR_CARDS_MASK,
+    SAME_COLOR_MASK(COLOR_BLUE) | COLOR_CARDS_MASK, SAME_COLOR_MASK(COLOR_GREEN) | COLOR_CARDS_MASK
+};
 
-    return len / 2; // Return the middle index of the length of the string.
-}
+// The cards that can be dropped in an open TAKI sequence, indexed by the color of the top card. The same rules as Check_Taki_Card.
+const uint64_t TAKI_PLAY_MASKS[NUM_OF_COLORS + 1] =
+{
+    COLOR_CARDS_MASK, SAME_COLOR_MASK(COLOR_YELLOW) | COLOR_CARDS_MASK, SAME_COLOR_MASK(COLOR_RED) | COLOR_CARDS_MASK,
+    SAME_COLOR_MASK(COLOR_BLUE) | COLOR_CARDS_MASK, SAME_COLOR_MASK(COLOR_GREEN) | COLOR_CARDS_MASK
+};
 
 
 /*
- * Add a new stat that doesn't already exist in the stats array.
- * Receives a pointer to the game's data and the card to be added to the stats array.
+ * Encode a card from its type, color and number.
+ * Receives the card's type, its color (COLOR_NONE for a COLOR card without a chosen color) and its number (unused for special cards).
+ * Returns the card code.
  */
-void Add_Game_Stat(GAME_DATA* game_data_p, CARD card)
+CARD Make_Card(CARD_TYPE type, CARD_COLOR color, int num)
 {
-    // Copy the card's name into a new stat.
-    strcpy(game_data_p->stats[game_data_p->nof_stats].card_type, card.type);
+    switch (type)
+    {
+        case TYPE_NORMAL:
+            return FIRST_NORMAL_CODE + (color - 1) * NOF_NUMBERS + (num - 1);
 
-    // Copy the card's number into the new stat.
-    game_data_p->stats[game_data_p->nof_stats].card_num = card.num;
+        case TYPE_COLOR:
+            return FIRST_COLOR_CODE + color;
 
-    // Add 1 to the card's frequency in the game.
-    game_data_p->stats[game_data_p->nof_stats].card_freq++;
+        case TYPE_TAKI: // TAKI comes after COLOR in CARD_TYPE, but is the 4th colored special card.
+            return FIRST_SPECIAL_CODE + (NOF_COLORED_SPECIALS - 1) * NUM_OF_COLORS + (color - 1);
 
-    // Add 1 to the number of stats in the stats array.
-    game_data_p->nof_stats++;
+        default: // "+" / "STOP" / "<->" are the first 3 colored special cards.
+            return FIRST_SPECIAL_CODE + type * NUM_OF_COLORS + (color - 1);
+    }
 }
 
 
+
+
+// -------------------- Hand Functions ---------------------
+
 /*
- * Check if a card is in the game statistics,
- * if it is then add 1 to the frequency of that card,
- * if it isn't then adds the card into the game statistics array.
+ * Initialize a hand with no cards.
+ * Receives a pointer to the hand.
  */
-void Check_Stat_Normal_Card(GAME_DATA* game_data_p, CARD card)
+void Hand_Init(HAND* hand_p)
 {
-    int nof_stats = game_data_p->nof_stats; // Get the number of stats in the stats array.
-    STAT_DATA* stats_array = game_data_p->stats; // Get a pointer to the stats array.
-
-    // Check every stat in the stats array to find if the card is already in the stats array.
-    for(int stat_i = 0; stat_i < nof_stats; stat_i++)
-    {
-        // Check if the card is already in the stats array.
-        if (card.num == stats_array[stat_i].card_num)
-        {
-            // The card is in the stats array, add 1 to its frequency.
-            stats_array[stat_i].card_freq++;
-            return; // End the function, found the card.
-        }
-    }
-    // The card isn't in the stats array, add the card to the game stats.
-    Add_Game_Stat(game_data_p, card);
+    memset(hand_p, 0, sizeof(HAND));
 }
 
 
 /*
- * Check if a card is in the game statistics,
- * if it is then add 1 to the frequency of that card,
- * if it isn't then adds the card into the game statistics array.
+ * Put the cards of a hand in an array, in the order they are printed: the normal cards by color and number, then the special cards by type and color.
+ * Receives a pointer to the hand and an array for the cards, with space for all the cards of the hand.
+ * Only the card codes the hand has are visited.
+ * Returns the number of cards.
  */
-void Check_Stat_Special_Card(GAME_DATA* game_data_p, CARD card)
+int Hand_Get_Cards(const HAND* hand_p, CARD cards[])
 {
-    int nof_stats = game_data_p->nof_stats; // Get the number of stats in the stats array.
-    STAT_DATA* stats_array = game_data_p->stats; // Get a pointer to the stats array.
+    uint64_t code_mask = hand_p->code_mask; // The card codes left to put in the array.
+    int nof_cards = 0; // The number of cards put in the array.
 
-    // Check every stat in the stats array to find if the card is already in the stats array.
-    for(int stat_i = 0; stat_i < nof_stats; stat_i++)
+    while (code_mask != 0)
     {
-        // Check if the card is already in the stats array.
-        if (!strcmp(card.type, stats_array[stat_i].card_type))
-        {
-            // The card is in the stats array, add 1 to its frequency.
-            stats_array[stat_i].card_freq++;
-            return; // End the function, found the card.
-        }
+        CARD card = (CARD) __builtin_ctzll(code_mask); // The lowest card code left.
+
+        // Put every card with this card code.
+        for (uint32_t count = 0; count < hand_p->counts[card]; count++)
+            cards[nof_cards++] = card;
+
+        code_mask &= code_mask - 1; // Move to the next card code.
     }
-    // The card isn't in the stats array, add the card to the game stats.
-    Add_Game_Stat(game_data_p, card);
+
+    return nof_cards;
 }
 
 
+
+
+// -------------------- Everything Else Functions ---------------------
+
 /*
- * Receives a color number between 0 and 3, returns the correct color char.
+ * Seed a random numbers generator.
+ * Receives a pointer to the generator, the seed and the stream. Generators with different streams give independent sequences,
+ * so parallel games can share a seed and use the game's number as the stream.
  */
-char Get_Color_Char(int color_num)
+void Rng_Seed(RNG* rng_p, uint64_t seed, uint64_t stream)
 {
-    // Check the received color number from 0 to 3. Chose the card's color depending on what number was received.
-    switch (color_num)
-    {
-        case 1: // The color number received is 1.
-            return YELLOW; // Set the card's color to YELLOW ('Y')
-        case 2: // The color number received is 2.
-            return RED; // Set the card's color to RED ('R')
-        case 3: // The color number received is 3.
-            return BLUE; // Set the card's color to BLUE ('B')
-        case 4: // The color number received is 4.
-            return GREEN; // Set the card's color to GREEN ('G')
-        default:
-            printf("ERROR: INVALID NUMBER RECEIVED!"); // If the function received invalid input.
-
-    }
-    return ERROR; // If for some reason the function received a wrong input color number, return error value.
+    rng_p->state = 0;
+    rng_p->inc = (stream << 1) | 1; // The increment must be odd.
+    Rng_Next(rng_p);
+    rng_p->state += seed;
+    Rng_Next(rng_p);
 }
 
 
 /*
  * Generates a random color from - (green/red/yellow/blue).
- * The seed for the random function needs to be set in the main function!
- * Returns the result color character. ('G' / 'R' / 'Y' / 'B')
+ * Receives a pointer to the game's random numbers generator.
+ * Returns the result color.
  */
-char Get_Random_Color()
+CARD_COLOR Get_Random_Color(RNG* rng_p)
 {
-    int card_color_num = rand() % NUM_OF_COLORS + 1; // Get a random number from 1 to the number of colors in the game (4), which will represent the card's color.
-    char card_color_char; // The color's character.
-
-    // Get the character that represents the card's color.
-    card_color_char = Get_Color_Char(card_color_num);
-
-    return  card_color_char; // Return the result card color.
+    // Get a random number from 1 to the number of colors in the game (4), which represents the card's color.
+    return (CARD_COLOR) (Rng_Below(rng_p, NUM_OF_COLORS) + 1);
 }
 
 
 /*
  * Gets a random normal card with a random card number, a random color, and the card type of NORMAL.
- * The seed for the random function needs to be set in the main function!
- * Receives a pointer to the card's location where the card should be saved.
+ * Receives a pointer to the game's random numbers generator and a pointer to the card's location where the card should be saved.
  */
-void Get_Random_Normal_Card(CARD* result_card_p)
+void Get_Random_Normal_Card(RNG* rng_p, CARD* result_card_p)
 {
-    int card_num = 1 + rand() % 9; // Get a random card number from 1 to 9, which will be the card's number.
-    char card_type[] = NORMAL; // The type of the card is normal. (the function runs for normal cards only)
+    int card_num = 1 + Rng_Below(rng_p, NOF_NUMBERS); // Get a random card number from 1 to 9, which will be the card's number.
 
-    // Set the cards' info with the randomized card number and card color, in the result card. The type of card is a normal card.
-    strcpy(result_card_p->type, card_type); // Set the result card's type to: NORMAL.
-    result_card_p->num = card_num; // Set the result card's number to the random number received.
-    result_card_p->color = Get_Random_Color(); // Get a random color and set the result as the card's color.
+    // Set the card with the randomized card number and a random color, in the result card. The type of card is a normal card.
+    *result_card_p = Make_Card(TYPE_NORMAL, Get_Random_Color(rng_p), card_num);
 }
 
 
 /*
- * Take a random card, can be a normal card and can be one of the special cards.
- * Receives a pointer to the card's location where the random card will be saved.
+ * Take the next card of the game's deck: the top card of the draw pile of a finite deck, or a random card of an infinite deck.
+ * Receives a pointer to the game's data and a pointer to the card's location where the card will be saved.
+ * Returns true if a card was taken, false if all the cards of a finite deck are in the players' hands and on the top of the deck.
  */
-void Take_Random_Card(CARD* result_card_p)
+bool Take_Card(GAME_DATA* game_data_p, CARD* result_card_p)
 {
-    int card_color = Get_Random_Color(); // Get a random color for the card (green/red/yellow/blue).
-    int rnd_card_type_num = rand() % NOF_CARD_TYPES; // Get a random number from 0 to the number of card types (not included), which will represent the card's type.
+    if (game_data_p->deck.is_finite)
+        return Deck_Draw(&game_data_p->deck, &game_data_p->rng, result_card_p);
 
-    result_card_p->color = card_color; // Set the color of the card to the random color received (the COLOR special card will override this value, so it will not contain a color).
-    result_card_p->num = EMPTY; // Initialize the card number to be EMPTY (-1), in the special cards the card number is empty and unused (the NORMAL card will override this value with the random card number received).
-
-    // Handle each card type accordingly:
-    // The possible card types are: "+" / "STOP" / "<->" / "COLOR" / "TAKI" / "NORMAL"
-    switch (rnd_card_type_num)
-    {
-        // Card type will be "+".
-        case 0:
-            strcpy(result_card_p->type, PLUS); // Set the result card's type to: +.
-            break;
-
-            // Card type will be "STOP".
-        case 1:
-            strcpy(result_card_p->type, STOP); // Set the result card's type to: STOP.
-            break;
+    Take_Random_Card(&game_data_p->rng, result_card_p);
+    return true;
+}
 
-            // Card type will be "<->".
-        case 2:
-            strcpy(result_card_p->type, DIRECTION); // Set the result card's type to: <->.
-            break;
 
-            // Card type will be "COLOR".
-        case 3:
-            strcpy(result_card_p->type, COLOR); // Set the result card's type to: COLOR.
-            result_card_p->color = NO_COLOR; // Sets the color of the card to be empty. The player will choose the color when he will play the card.
-            break;
+/*
+ * Take a random card, can be a normal card and can be one of the special cards.
+ * Receives a pointer to the game's random numbers generator and a pointer to the card's location where the random card will be saved.
+ */
+void Take_Random_Card(RNG* rng_p, CARD* result_card_p)
+{
+    CARD_COLOR card_color = Get_Random_Color(rng_p); // Get a random color for the card (green/red/yellow/blue).
+    CARD_TYPE card_type = (CARD_TYPE) Rng_Below(rng_p, NOF_CARD_TYPES); // Get a random number from 0 to the number of card types (not included), which represents the card's type in the order of CARD_TYPE.
+    int card_num = EMPTY; // In the special cards the card number is empty and unused.
 
-            // Card type will be "TAKI".
-        case 4:
-            strcpy(result_card_p->type, TAKI); // Set the result card's type to: TAKI.
-            break;
+    // The possible card types are: "+" / "STOP" / "<->" / "COLOR" / "TAKI" / "NORMAL"
+    if (card_type == TYPE_NORMAL)
+        card_num = 1 + Rng_Below(rng_p, NOF_NUMBERS); // Get a random card number from 1 to 9, which will be the card's number.
+    else
+        if (card_type == TYPE_COLOR)
+            card_color = COLOR_NONE; // The player will choose the color when he will play the card.
 
-            // Card type will be "NORMAL".
-        case 5:
-            strcpy(result_card_p->type, NORMAL); // Set the result card's type to: NORMAL.
-            result_card_p->num = 1 + rand() % 9; // Get a random card number from 1 to 9, which will be the card's number.
-            break;
-    }
+    *result_card_p = Make_Card(card_type, card_color, card_num); // Encode the card.
 }
 
 
@@ -653,15 +417,15 @@ void Take_Random_Card(CARD* result_card_p)
 bool Check_Normal_Card(CARD normal_card, CARD top_card)
 {
     // Check if the cards' colors are equal.
-    if (normal_card.color == top_card.color)
+    if (Get_Card_Color(normal_card) == Get_Card_Color(top_card))
         return true; // The colors are equal, returns true, can drop the card.
 
     // Check if one of the cards doesn't have a number in it.
-    if (normal_card.num == EMPTY || top_card.num == EMPTY)
+    if (Get_Card_Num(normal_card) == EMPTY || Get_Card_Num(top_card) == EMPTY)
         return false; // The cards have different colors, and at least one doesn't have a number. Can't drop the card so returns false.
 
     // Check if the number of the card to check is equal to the number of the top card.
-    if (normal_card.num == top_card.num)
+    if (Get_Card_Num(normal_card) == Get_Card_Num(top_card))
         return true; // The cards' numbers are equal, returns true, Can drop the card.
 
     // The cards' numbers and colors aren't equal, returns false, can't drop the card.
@@ -678,15 +442,15 @@ bool Check_Normal_Card(CARD normal_card, CARD top_card)
 bool Check_Special_Card(CARD special_card, CARD top_card)
 {
     // If the card has no color, the card is a color card, and it can be dropped on top of every color.
-    if (special_card.color == NO_COLOR)
+    if (Get_Card_Color(special_card) == COLOR_NONE)
         return true; // Can drop the card, return true.
 
     // Check if the cards' colors are equal.
-    if (special_card.color == top_card.color)
+    if (Get_Card_Color(special_card) == Get_Card_Color(top_card))
         return true; // The cards' colors are equal, returns true, can drop the card.
 
     // Check if the cards' types are equal.
-    if (!strcmp(special_card.type, top_card.type))
+    if (Get_Card_Type(special_card) == Get_Card_Type(top_card))
         return true; // The cards' types are equal, returns true, can drop the card.
 
     // The card's colors and types aren't equal, returns false, can't drop the card.
@@ -695,104 +459,111 @@ bool Check_Special_Card(CARD special_card, CARD top_card)
 
 
 /*
- * Drop a card from the player's cards,
- * Save that card as the new top card,
- * Remove the card from the cards array.
+ * Drop a card from the player's hand,
+ * Save that card as the new top card, the old top card goes to the discard pile of a finite deck.
+ * Receives a pointer to the game's data, a pointer to the player and the card to drop (the player needs to have it).
  */
-void Remove_Card_From_Array(PLAYER* player_p, int card_i, CARD* top_card_p)
+void Remove_Card_From_Hand(GAME_DATA* game_data_p, PLAYER* player_p, CARD card)
 {
-    *top_card_p = player_p->cards[card_i]; // Set the top card to the card that is being dropped.
+    if (game_data_p->deck.is_finite)
+        Deck_Discard(&game_data_p->deck, game_data_p->top_card);
 
-    // Remove the card from the player's cards array. Start at the index of the card being removed. Overwrites the card with the card on the next index, until the end of the cards array.
-    for (int i = card_i; i < player_p->nof_cards - 1; i++)
-        player_p->cards[i] = player_p->cards[i + 1]; // Move the card from the next index to the current index, overwrite the card on this current index.
+    game_data_p->top_card = card; // Set the top card to the card that is being dropped.
 
-    player_p->nof_cards--; // Subtract 1 from the number of cards the player has.
+    Hand_Remove(&player_p->hand, card); // Remove the card from the player's hand.
+    player_p->is_cards_array_updated = false; // The printed cards need to be built again.
 }
 
 
 /*
- * Draws a new random card for the player.
- * Checks if the card array is full, if it is then reallocates the cards array into a new location with double its size.
- * Then, adds a new random card into the cards array of the player.
- * Receives a pointer of the player that will be drawing a new card.
+ * Draws a new card from the deck for the player.
+ * Adds the new card into the hand of the player. If all the cards of a finite deck are taken, the player doesn't get a card.
+ * Receives a pointer to the game's data and a pointer of the player that will be drawing a new card.
  */
 void Draw_New_Card(GAME_DATA* game_data_p, PLAYER* player_p)
 {
-    CARD* new_card_p;
-
-    // Check if the cards array is full, then multiples its size by 2 to make new space for new cards.
-    if (player_p->nof_cards == player_p->cards_phys_size)
-    {
-        player_p->cards_phys_size *= 2; // Double the size of the cards array physical size.
+    CARD new_card; // The card drawn.
 
-        // Try to reallocate the memory of the cards with the new size. If successful, copies the array to the new location and frees the memory in the old location.
-        Reallocate_Cards_Array(player_p, player_p->cards_phys_size);
-    }
-    // Get a pointer to where the new card will be saved (in the index of the nof_card, which will be after the last card in the array).
-    new_card_p = &player_p->cards[player_p->nof_cards];
-
-    Take_Random_Card(new_card_p); // Add a new card to the player's cards.
-    player_p->nof_cards++; // Add 1 to the number of cards the player has.
+    if (!Take_Card(game_data_p, &new_card)) // Get a card from the deck.
+        return;
+    Hand_Add(&player_p->hand, new_card); // Add the new card to the player's hand.
+    player_p->is_cards_array_updated = false; // The printed cards need to be built again.
+    game_data_p->last_drawn_card = new_card;
 
-    // Add the card into the game stats. Check if the card received is a normal card.
-    if (!strcmp(new_card_p->type, NORMAL))
-        Check_Stat_Normal_Card(game_data_p, *new_card_p); // Add the normal card to the stats array.
-    else // The card is not a normal card, so it's a special card.
-        Check_Stat_Special_Card(game_data_p, *new_card_p); // Add the special card to the stats array.
+    Add_Card_Stat(game_data_p, new_card); // Add the card into the game stats.
 }
 
 
 /*
- * Tries to drop a normal card on the current top card.
- * Checks if the card's number or color match those of the current top card.
- * If they match, drops the card and returns true.
- * Else, returns false.
- * Receives a pointer to the player, the card's index and a pointer to the top card.
+ * Check if it is possible to drop a card while a TAKI sequence is open.
+ * Inside a TAKI sequence the player can drop any card with the same color as the top card,
+ * or a COLOR card which takes the color of the top card and closes the sequence.
+ * Receives the card to be checked and the card at the top of the deck.
+ * Returns true if it is possible to drop the card, returns false otherwise.
  */
-bool Play_Normal_Card(PLAYER* player_p, int card_i, CARD* top_card_p)
+bool Check_Taki_Card(CARD card, CARD top_card)
 {
-    // Get the card to play.
-    CARD normal_card = player_p->cards[card_i];
+    // A COLOR card can always close the TAKI sequence.
+    if (Get_Card_Type(card) == TYPE_COLOR)
+        return true;
+
+    // Any other card must have the same color as the top card.
+    return Get_Card_Color(card) == Get_Card_Color(top_card);
+}
 
-    // Check if the card can be dropped on top of the top card.
-    if (Check_Normal_Card(normal_card, *top_card_p))
-    {
-        // Can drop the card on top of the current top card. Drop the card:
-        Remove_Card_From_Array(player_p, card_i, top_card_p);
-        return true; // The card dropped successfully, Returns true.
-    }
 
-    return false; // The card couldn't be played, returns false.
+/*
+ * Check if a color character is one of the game's colors (green/red/yellow/blue).
+ */
+bool Is_Valid_Color(CARD_COLOR color)
+{
+    return COLOR_YELLOW <= color && color <= COLOR_GREEN;
 }
 
 
 /*
- * Lets the player choose what color the card will be.
- * Sets that color as the card's color.
- * Receives a pointer to the player and the color card's index.
+ * Check if the current player can drop a card on top of the current top card.
+ * Uses the TAKI sequence rules if a sequence is open, otherwise the normal or special card rules.
+ * Receives a pointer to the game's data, the card to be checked and the color chosen for a COLOR card.
+ * Returns true if the card can be dropped, false otherwise.
  */
-void Play_Color_Card(PLAYER* player, int card_i)
+bool Check_Play_Card(const GAME_DATA* game_data_p, CARD card, CARD_COLOR color)
 {
-    int color_choice; // The menu choice for the color of the card.
+    // Inside a TAKI sequence only the sequence rules apply. (a COLOR card takes the color of the top card, so the chosen color is ignored)
+    if (game_data_p->is_taki_open)
+        return Check_Taki_Card(card, game_data_p->top_card);
+
+    // Check if the card type is: "NORMAL".
+    if (Get_Card_Type(card) == TYPE_NORMAL)
+        return Check_Normal_Card(card, game_data_p->top_card);
 
-    // Request a color for the card from the player.
-    printf("Please enter your color choice:\n1 - Yellow\n2 - Red\n3 - Blue\n4 - Green\n");
-    scanf("%d", &color_choice); // Get the color's number.
+    // A COLOR card needs a valid color to be chosen for it.
+    if (Get_Card_Type(card) == TYPE_COLOR && !Is_Valid_Color(color))
+        return false;
 
-    player->cards[card_i].color = Get_Color_Char(color_choice); // Get the character that represents the wanted color.
+    return Check_Special_Card(card, game_data_p->top_card);
+}
+
+
+/*
+ * Sets the color chosen by the player as the color of the COLOR card on top of the deck.
+ * Receives a pointer to the game's data and the chosen color.
+ */
+void Play_Color_Card(GAME_DATA* game_data_p, CARD_COLOR color)
+{
+    game_data_p->top_card = Make_Card(TYPE_COLOR, color, EMPTY); // Set the chosen color, the card will show it on the top of the deck.
 }
 
 
 /*
  * Skips the player on the next turn.
  * If the stop card was the last card, and there are only 2 players in the game, then draws a new card for the player and gives the player another turn.
- * Receives a pointer to the game's data and a pointer to the player.
+ * Receives a pointer to the game's data and a pointer to the player. The STOP card was already removed from the player's cards.
  */
 void Play_Stop_Card(GAME_DATA* game_data_p, PLAYER* player_p)
 {
-    // Check if the stop card is the last card, and that there are 2 players in the game, then the player needs to draw a card.
-    if (player_p->nof_cards - 1 == 0 && game_data_p->nof_players == 2)
+    // Check if the stop card was the last card, and that there are 2 players in the game, then the player needs to draw a card.
+    if (player_p->hand.nof_cards == 0 && game_data_p->nof_players == 2)
         Draw_New_Card(game_data_p, player_p); // Draw a new card.
 
     // Check if the direction is to the right.
@@ -816,104 +587,46 @@ void Play_Direction_Card(GAME_DATA* game_data_p)
 
 
 /*
- * Play TAKI card, enables to play multiple cards of the same color on one turn.
- * Removes the TAKI card from the player's cards array,
- * Lets the player chose to end the turn or place more cards,
- * If the player dropped all his cards, check if the last card dropped was a special card that requires to draw a card,
- * If it wasn't, then the player won the game and ends the function.
- * Receives a pointer to the game's data, a pointer to the player and the index of the TAKI card in the player's cards array.
+ * Opens a TAKI sequence, enables to play multiple cards of the same color on one turn.
+ * The turn continues until the player closes the sequence with MOVE_END_TAKI, drops a COLOR card, or drops all his cards.
+ * If the TAKI card was the last card of the player, the sequence is closed right away.
+ * Receives a pointer to the game's data and a pointer to the player. The TAKI card was already removed from the player's cards.
  */
-void Play_Taki_Card(GAME_DATA* game_data_p, PLAYER* player_p, int taki_card_i)
+void Play_Taki_Card(GAME_DATA* game_data_p, PLAYER* player_p)
 {
-    int card_choice, card_index; // The card choice: number from 1 to the number of cards, and the card's index in the cards array.
-    CARD chosen_card; // The chosen card's data.
-
-    Remove_Card_From_Array(player_p, taki_card_i, &game_data_p->top_card); // Removes the TAKI card from the cards array of the player.
+    game_data_p->is_taki_open = true; // Open the sequence, the player keeps his turn.
 
-    while(true) // While the player can drop more cards, until one of the if statements is met.
-    {
-        // Check if the player dropped all his cards in the TAKI sequence.
-        if (player_p->nof_cards == 0)
-        {
-            // Check if the last card dropped was a PLUS card, so the player needs to draw a card.
-            if (!strcmp(game_data_p->top_card.type, PLUS))
-            {
-                Draw_New_Card(game_data_p, player_p); // Give the player a card.
-                return; // Ends the turn.
-            }
-            // Check if the last card dropped was a STOP card, and the number of players in the game is 2, so the player needs to draw a card.
-            if (!strcmp(game_data_p->top_card.type, STOP) && game_data_p->nof_players == 2)
-            {
-                Draw_New_Card(game_data_p, player_p); // Give the player a card.
-                return; // Ends the turn.
-            }
-
-            // The last card dropped didn't require to draw a new card, so the player won the game.
-            game_data_p->is_game_won = true; // Set the game to be finished.
-            return; // Finish the function.
-        }
-        // Print the current top card, the player's name and all of his cards.
-        Print_Current_Deck(game_data_p->top_card, *player_p);
-
-        // Print request message for the player's choice of play. 0 to end the turn or 1 to the number of cards to play that card.
-        printf("Please enter 0 if you want to finish your turn\nor 1-%d if you want to put one of your cards in the middle:\n", player_p->nof_cards);
-        scanf("%d", &card_choice); // Get the choice input.
-
-        if (card_choice == 0) // Player chose to end his turn.
-        {
-            // Check if the last card dropped was a special card, if it was, use that card.
-            if (!strcmp(game_data_p->top_card.type, PLUS)) // Check if the card was PLUS card.
-                Play_Plus_Card(game_data_p, player_p, card_index); // Give the player another turn.
-            else
-                if (!strcmp(game_data_p->top_card.type, STOP)) // Check if the card was STOP card.
-                    Play_Stop_Card(game_data_p, player_p); // Skip the next player's turn.
-                else
-                    if (!strcmp(game_data_p->top_card.type, DIRECTION)) // Check if the card was DIRECTION card.
-                        Play_Direction_Card(game_data_p); // Swap the direction of the game.
-
-            return; // End the function, the sequence is finished.
-        }
-
-        // Check if the player entered a wrong input, if so he will be requested for a new input in a new loop sequence.
-        if (card_choice >= player_p->nof_cards) { printf("Invalid card! Try again.\n"); continue; }
-
-        card_index = card_choice - 1; // Get the chosen card's index.
-        chosen_card = player_p->cards[card_index]; // Get the card chosen.
-
-        // Check if the chosen card's type is color.
-        if (!strcmp(chosen_card.type, COLOR))
-        {
-            // Updates the chosen card's color to be the same color as the current top card's.
-            player_p->cards[card_index].color = game_data_p->top_card.color;
-
-            // Remove the chosen card from the cards array of the player. Also update the top card.
-            Remove_Card_From_Array(player_p, card_index, &game_data_p->top_card);
+    // Check if the player has no more cards to drop in the sequence.
+    if (player_p->hand.nof_cards == 0)
+        Close_Taki_Sequence(game_data_p, player_p);
+}
 
-            return; // Ends the player's turn, can't put more cards after the color card in TAKI sequence.
-        }
 
-        // Check if the chosen card's color isn't the same color as the top card's. Continue to a new loop sequence for a new choice.
-        if (chosen_card.color != game_data_p->top_card.color) { printf("Invalid card! Try again.\n"); continue; }
+/*
+ * Closes the open TAKI sequence.
+ * The last card dropped in the sequence takes effect: PLUS gives another turn, STOP skips the next player and <-> switches the direction.
+ * If the player dropped all his cards, PLUS and STOP (with 2 players) make the player draw a card, as they do outside of a sequence.
+ * Receives a pointer to the game's data and a pointer to the player.
+ */
+void Close_Taki_Sequence(GAME_DATA* game_data_p, PLAYER* player_p)
+{
+    game_data_p->is_taki_open = false; // Close the sequence.
 
-        // Remove the chosen card from the cards array of the player. Also update the top card.
-        Remove_Card_From_Array(player_p, card_index, &game_data_p->top_card);
-    }
+    // A TAKI card on top doesn't open a new sequence when the sequence is closed.
+    if (Get_Card_Type(game_data_p->top_card) != TYPE_TAKI)
+        Play_Card_Effect(game_data_p, player_p, game_data_p->top_card); // Use the last card dropped.
 }
 
 
 /*
  * Gives the player another turn.
- * Removes the PLUS card from the cards array of the player.
  * If the PLUS card was the last card of the player, draws a new card and ends the turn.
  * If it wasn't, move back one turn so when the turn will go to the next player, it will actually go to this player and give him another turn.
- * Receives a pointer to the game's data, a pointer to the player and the card index of the PLUS card.
+ * Receives a pointer to the game's data and a pointer to the player. The PLUS card was already removed from the player's cards.
  */
-void Play_Plus_Card(GAME_DATA* game_data_p, PLAYER* player_p, int plus_card_i)
+void Play_Plus_Card(GAME_DATA* game_data_p, PLAYER* player_p)
 {
-    // Removes the card from the cards array of the player. Also update the top card.
-    Remove_Card_From_Array(player_p, plus_card_i, &game_data_p->top_card);
-
-    if (player_p->nof_cards == 0) // Check if the PLUS card was the last card of the player.
+    if (player_p->hand.nof_cards == 0) // Check if the PLUS card was the last card of the player.
         Draw_New_Card(game_data_p, player_p); // The PLUS card was the last card, draws a new card.
     else
     {
@@ -927,184 +640,156 @@ void Play_Plus_Card(GAME_DATA* game_data_p, PLAYER* player_p, int plus_card_i)
 
 
 /*
- * Checks if the player dropped all his cards,
- * Prints the winners name and ends the program. The game is finished.
- * Returns true if the player won, and false if he didn't.
- * Receives player struct to be checked.
+ * Build the stats of the cards drawn from the frequency table of the card codes.
+ * The colors of each card are counted together: a normal card stat is by its number, a special card stat is by its type.
+ * Receives the frequency table and an array for the stats (GAME_STATS_MAX_SIZE stats).
+ * Returns the number of stats, only cards that were drawn have a stat.
  */
-bool Check_Winner(PLAYER player)
+int Build_Stats_View(const unsigned long long card_freqs[], STAT_DATA stats[])
 {
-    // Check if the player dropped all of his cards, if so then the game is finished and the player has won.
-    if (player.nof_cards == 0)
+    unsigned long long freqs[GAME_STATS_MAX_SIZE] = { 0 }; // The frequency of every stat: number cards by number, then special cards by type.
+    int nof_stats = 0; // The number of stats of cards that were drawn.
+
+    // Add the frequency of every card code to its stat.
+    for (int card = 0; card < NOF_CARD_CODES; card++)
     {
-        // Game Finished!!!
-        // Print the finished game message with the winner's name.
-        printf("\nThe winner is... %s! Congratulations!\n", player.name);
+        if (Get_Card_Type(card) == TYPE_NORMAL)
+            freqs[Get_Card_Num(card) - 1] += card_freqs[card];
+        else
+            freqs[FIRST_SPECIAL_STAT + Get_Card_Type(card)] += card_freqs[card];
+    }
+
+    // Keep the stats of the cards that were drawn.
+    for (int stat_i = 0; stat_i < GAME_STATS_MAX_SIZE; stat_i++)
+    {
+        if (freqs[stat_i] == 0)
+            continue;
 
-        return true; // The player has won, returns true.
+        stats[nof_stats].card_type = stat_i < FIRST_SPECIAL_STAT ? TYPE_NORMAL : (CARD_TYPE) (stat_i - FIRST_SPECIAL_STAT);
+        stats[nof_stats].card_num = stat_i < FIRST_SPECIAL_STAT ? stat_i + 1 : EMPTY;
+        stats[nof_stats].card_freq = freqs[stat_i];
+        nof_stats++;
     }
-    return false; // The player didn't win, returns false.
+
+    return nof_stats;
 }
 
 
 /*
- * Sort the stats array in the game's data by the frequency of the cards.
+ * Sort an array of stats by the frequency of the cards.
  * The card that was drawn most times will be at the first index, with descending order for the other cards' frequencies.
- * Sorts by the bubble sort method, pushes the stats with the lower frequencies to the right, until the array is sorted.
- * Receives pointer to the game's data.
+ * Sorts by the insertion sort method, stats with equal frequencies keep their order.
+ * Receives the array of stats and the number of stats in it.
  */
-void Sort_Stats_Array(GAME_DATA* game_data_p)
+void Sort_Stats_Array(STAT_DATA stats[], int nof_stats)
 {
-    int i, j; // The indexes as mentioned later.
-    STAT_DATA* stats_array = game_data_p->stats; // Get the array containing the stats.
-    int nof_stats = game_data_p->nof_stats; // Get the number of stats in the array.
-
-    // i = the limit on the right of the array, after the limit the sorted stats will take their spots.
-    // j = the current stat index where we check if the stat's frequency is lower than the one that comes after it.
-    for (i = 0; i < nof_stats - 1; i++)
-        for (j = 0; j < nof_stats - i - 1; j++)
-            if (stats_array[j].card_freq < stats_array[j + 1].card_freq) // Check if the stat freq in the current index is lower than the stat freq in the next index.
-                Swap_Stats(stats_array, j, j + 1); // Swaps the stats so the one with the lower freq will move to the right.
+    // Insert every stat into its place among the sorted stats before it.
+    for (int i = 1; i < nof_stats; i++)
+    {
+        STAT_DATA stat = stats[i]; // The stat to insert.
+        int j = i; // The index where the stat will be inserted.
+
+        // Move the stats with a lower frequency one index to the right.
+        while (j > 0 && stats[j - 1].card_freq < stat.card_freq)
+        {
+            stats[j] = stats[j - 1];
+            j--;
+        }
+        stats[j] = stat;
+    }
 }
 
 
 /*
- * Swaps two stats in array of stats.
- * Receives array of stats and the indexes of the stats to swap.
+ * Add the frequency table of cards drawn to a total frequency table of many games.
+ * Receives the total frequency table and the frequency table to add.
  */
-void Swap_Stats(STAT_DATA stats[], int first_i, int second_i) {
-    STAT_DATA tmp_stat = stats[first_i]; // Get the value of the stat in the first index into a temp variable, because the first index value is later overwritten.
-    stats[first_i] = stats[second_i]; // Set the stat at the first index as the stat in the second index.
-    stats[second_i] = tmp_stat; // Set the stat from the temp variable into the second index.
+void Merge_Card_Stats(unsigned long long total_freqs[], const unsigned long long card_freqs[])
+{
+    for (int card = 0; card < NOF_CARD_CODES; card++)
+        total_freqs[card] += card_freqs[card];
 }
 
 
 /*
  * Try to play a card given.
  * Checks if it's possible to drop the card on top of the current top card. If it's not then returns false.
- * If it's possible to drop the card, calls for the right play card function that will player the card.
- * Receives a pointer to the game's data, a pointer to the player and the index of the card in the player's cards array.
- * Both TAKI and PLUS cards gives the player more turns, so they are handled differently, the cards needs to be removed in their functions, and then receive new cards.
+ * If it's possible to drop the card, removes it from the player's hand and calls for the right play card function that will play the card.
+ * Receives a pointer to the game's data, a pointer to the player, the card to drop and the color chosen for a COLOR card.
+ * Doesn't move the turn to the next player, the engine does it when the turn is finished.
  */
-bool Try_Play_Card(GAME_DATA* game_data_p, PLAYER* player_p, int card_i)
+bool Try_Play_Card(GAME_DATA* game_data_p, PLAYER* player_p, CARD card, CARD_COLOR color)
 {
-    CARD current_card = player_p->cards[card_i]; // Get the card that is being dropped.
+    // Check that the player has the card, and that it can be dropped on top of the top card.
+    if (card >= NOF_CARD_CODES || !Hand_Has_Card(&player_p->hand, card) || !Check_Play_Card(game_data_p, card, color))
+        return false; // Couldn't play the card, returns false.
 
-    // ------------------- Normal Card -------------------
-    // Check if the card type is: "NORMAL".
-    if (!strcmp(current_card.type, NORMAL))
-        return Play_Normal_Card(player_p, card_i, &game_data_p->top_card); // Try to drop the card, returns true if was successful, false if wasn't.
+    // ------------------- TAKI Sequence -------------------
+    if (game_data_p->is_taki_open)
+    {
+        CARD_COLOR sequence_color = Get_Card_Color(game_data_p->top_card); // The color of the sequence, the color of the card below the dropped card.
+
+        // Remove the chosen card from the player's hand. Also update the top card.
+        Remove_Card_From_Hand(game_data_p, player_p, card);
+
+        // Check if the chosen card's type is color.
+        if (Get_Card_Type(card) == TYPE_COLOR)
+        {
+            // Updates the card's color to be the same color as the sequence, and closes the sequence without any card effect.
+            Play_Color_Card(game_data_p, sequence_color);
+            game_data_p->is_taki_open = false;
+            return true;
+        }
+
+        // Check if the player dropped all his cards in the TAKI sequence.
+        if (player_p->hand.nof_cards == 0)
+            Close_Taki_Sequence(game_data_p, player_p);
 
-    // ------------------- Special Cards -------------------
-    // cards types: "+" / "STOP" / "<->" / "COLOR" / "TAKI"
+        return true;
+    }
 
-    // The card wasn't a normal card, check if the special card can be dropped on top of the top card.
-    if (!Check_Special_Card(current_card, game_data_p->top_card))
-        return false; // Couldn't play the special card, returns false.
+    // ------------------- Single Card -------------------
+    // Removes the card from the player's hand. Also update the top card.
+    Remove_Card_From_Hand(game_data_p, player_p, card);
+
+    // Check if the card type is: "COLOR", then set the chosen color.
+    if (Get_Card_Type(card) == TYPE_COLOR)
+        Play_Color_Card(game_data_p, color);
+
+    // Use the card's effect. ("NORMAL" and "COLOR" cards have no effect after being dropped)
+    Play_Card_Effect(game_data_p, player_p, game_data_p->top_card);
 
-    // The card can be dropped, checks the card's type.
-    // Check if the card type is: "STOP".
-    if (!strcmp(current_card.type, STOP))
-        Play_Stop_Card(game_data_p, player_p); // Skip the next player's turn.
-    else
-        // Check if the card type is: "<->".
-        if (!strcmp(current_card.type, DIRECTION))
-            Play_Direction_Card(game_data_p); // Change the direction of the game.
-        else
-            // Check if the card type is: "COLOR".
-            if (!strcmp(current_card.type, COLOR))
-                Play_Color_Card(player_p, card_i); // Let the player chose the color of the card.
-            else
-                // Check if the card type is: "TAKI"".
-                if (!strcmp(current_card.type, TAKI))
-                {
-                    Play_Taki_Card(game_data_p, player_p, card_i); // Play the TAKI card, also removes the card from the array.
-                    return true; // Finished dropping the card.
-                }
-                else
-                    // Check if the card type is: "+".
-                    if (!strcmp(current_card.type, PLUS))
-                    {
-                        Play_Plus_Card(game_data_p, player_p, card_i); // Play the PLUS card, also removes the card from the array.
-                        return true; // Finished dropping the card.
-                    }
-
-    // Removes the card from the cards array of the player. Also update the top card.
-    // Note that the TAKI and PLUS cards were already removed and left the function before this line.
-    Remove_Card_From_Array(player_p, card_i, &game_data_p->top_card);
     return true; // Returns true, the card was dropped.
 }
 
 
 /*
- * Start playing the game.
- * Receives a pointer to the game's data.
+ * Use the effect of a special card that was dropped.
+ * Receives a pointer to the game's data, a pointer to the player who dropped the card and the card.
+ * cards types with effects: "+" / "STOP" / "<->" / "TAKI"
  */
-void Play_Game(GAME_DATA* game_data_p)
+void Play_Card_Effect(GAME_DATA* game_data_p, PLAYER* player_p, CARD card)
 {
-    PLAYER* current_player_p; // A pointer to the player that is currently playing.
-    PLAYER current_player; // The player that is currently playing.
-    int card_chosen; // The number of the card wished to be played. If 0, then draw a new card.
-    bool is_play_successful; // If a card was successfully dropped.
-
-    // While no player has dropped all his cards.
-    while(!game_data_p->is_game_won)
+    // Check the card's type.
+    switch (Get_Card_Type(card))
     {
-        // Check if finished a full revolution of turns, every player played his turn, so restarts to the first/last player according to the game's direction. If a stop card was played, then it will skip the turn of that first/last player.
-        if (game_data_p->is_direction_right && game_data_p->player_index >= game_data_p->nof_players)
-            game_data_p->player_index -= game_data_p->nof_players; // Game direction is to the right, then subtracts the number of players from the index to start from the first player.
-        else
-            if (!game_data_p->is_direction_right && game_data_p->player_index <= -1)
-                game_data_p->player_index += game_data_p->nof_players; // Game direction is to the left, then adds the number of players to the index to start from the last player.
+        case TYPE_STOP:
+            Play_Stop_Card(game_data_p, player_p); // Skip the next player's turn.
+            break;
 
-        // ------------------ Each player gets to play his turn: ------------------
-        current_player_p = &game_data_p->players[game_data_p->player_index]; // Get a pointer to the data of the player that is currently playing.
-        current_player = *current_player_p; // Get the values of the player's data.
+        case TYPE_DIRECTION:
+            Play_Direction_Card(game_data_p); // Change the direction of the game.
+            break;
 
-        // Print the current top card, the player's name and the player's cards.
-        Print_Current_Deck(game_data_p->top_card, current_player);
+        case TYPE_TAKI:
+            Play_Taki_Card(game_data_p, player_p); // Open a TAKI sequence.
+            break;
 
-        // Until the player entered a valid input, keeps requesting for a card choice.
-        while (true)
-        {
-            // Print request message for what play the player wants to do. 0: Draw a card from the deck, 1 to number of cards: Drop a card the player has.
-            printf("Please enter 0 if you want to take a card from the deck\nor 1-%d if you want to put one of your cards in the middle:\n", current_player.nof_cards);
-            scanf("%d", &card_chosen); // Get the input for the card chosen.
-
-            // If the player chose to draw a new card.
-            if (card_chosen == 0)
-            {
-                Draw_New_Card(game_data_p, current_player_p); // Draw a random card, reallocates the memory of the cards array to fit the new card.
-                break; // Finished the turn.
-            }
-
-            // If the player wishes to drop a card that he has (player chose a number from 1- the first card, to the last card- the number of cards).
-            if (1 <= card_chosen <= current_player.nof_cards)
-            {
-                // Try to play the card, receive if the action was successful.
-                is_play_successful = Try_Play_Card(game_data_p, current_player_p, card_chosen - 1); // Play the card in the correct index of the array of cards- [card chosen number - 1] (the indexes start at 0 while our count starts at 1).
-
-                // If the card was successfully dropped.
-                if (is_play_successful)
-                {
-                    // Check if the player won the game.
-                    if (Check_Winner(*current_player_p))
-                    {
-                        game_data_p->is_game_won = true; // The game is finished, the player won the game.
-                        return; // Finish the game, return to the main function.
-                    }
-                    break; // Stop the loop, a card was dropped and the turn is finished.
-                }
-            }
-
-            // A card wasn't dropped, the player entered a wrong input and will be requested for a new input in a new loop sequence.
-            printf("Invalid card! Try again.\n"); // Print wrong input message.
-        }
+        case TYPE_PLUS:
+            Play_Plus_Card(game_data_p, player_p); // Give the player another turn.
+            break;
 
-        // Check the direction of the game and move the index accordingly.
-        if (game_data_p->is_direction_right)
-            game_data_p->player_index++; // Move index to the right.
-        else
-            game_data_p->player_index--; // Move index to the left.
+        default: // "NORMAL" and "COLOR" cards have no effect.
+            break;
     }
 }
\ No newline at end of file
@@ -7,21 +7,45 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <math.h>
+#include <dlfcn.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "taki.h" // The engine's library, libtaki.
+#include "taki_policy.h" // The ABI of the policy plugins.
 
 // ----------- Constants ----------
 
-#define MAX_NAME_LEN 21 // The maximum length of the first name of each player. the maximum length is 20 charaters.
-#define MAX_CARD_NAME_LEN 7 // The maximum length of the special card's type string. (The longest string is 'NORMAL' which contains 7 characters)
-
 // Dimensions of each card:
 #define CARD_LENGTH 6
 #define CARD_WIDTH 9
 #define CARD_BORDER "*" // The character for the border of the cards
+#define CARD_GAP 2 // The number of spaces between cards printed side by side.
+#define MAX_LABEL_LEN 32 // The maximum length of the number printed above a card.
+#define DEFAULT_SCREEN_WIDTH 80 // The width of the screen when it can't be found (the output isn't a terminal).
+#define DEFAULT_SCREEN_HEIGHT 24 // The height of the screen when it can't be found.
 
-#define NOF_START_CARDS 4 // How many cards each player starts the game with.
-
-#define EMPTY -1 // Empty card number will be represented by -1, so the card number value in the special cards will be initialized to -1.
+// Full screen mode
+#define ANSI_ESC "\x1b" // Starts the ANSI escape sequences that move the cursor and set the colors.
+#define TUI_PROMPT_LINES 8 // The lines at the bottom of the screen for the questions and the answers of the players.
+#define TUI_MAX_REWRITE_GAP 4 // Unchanged cells shorter than a cursor move are written again instead of moving the cursor over them.
 
 // Characters for the cards' colors:  (green/red/yellow/blue).
 #define GREEN 'G'
@@ -30,7 +54,6 @@
 #define BLUE 'B'
 #define NO_COLOR ' '
 #define ERROR 'E'
-#define NUM_OF_COLORS 4 // The number of card colors in the game.
 
 // Types of cards: "+" / "STOP" / "<->" / "COLOR" / "TAKI" / "NORMAL".
 #define PLUS "+"
@@ -39,72 +62,347 @@
 #define COLOR "COLOR"
 #define TAKI "TAKI"
 #define NORMAL "NORMAL"
-#define NOF_CARD_TYPES 6 // Number of card types in the game.
 
-// Stats 
-#define GAME_STATS_MAX_SIZE 14 // The possible stats are for 9 number cards and 5 special cards, 14 in total.
-#define STAT_EMPTY "EMPTY" // Indicates that the stat is empty.
+// Stats
 #define COL_LEN 7 // The length of the stats collum.
 
+// Simulation
+#define MAX_SIM_PLAYERS 16 // The maximum number of players in a simulated game.
+
+// Frame
+#define FRAME_BUFFER_SIZE 16384 // The size of a frame's buffer, a bigger frame is written in parts.
+#define FRAME_LINE_SIZE 256 // The maximum length of a formatted text added to a frame.
+
+// The card codes and the number of players of the policy plugins' ABI (taki_policy.h) need to match the game's.
+_Static_assert(TAKI_NOF_CARD_CODES == NOF_CARD_CODES && TAKI_FIRST_SPECIAL_CODE == FIRST_SPECIAL_CODE && TAKI_COLOR_CARD_CODE == FIRST_COLOR_CODE,
+               "The card codes of taki_policy.h don't match the game's card codes.");
+_Static_assert(TAKI_MAX_PLAYERS == MAX_SIM_PLAYERS, "The players of taki_policy.h don't match the simulation's players.");
+
+// Benchmark definitions
+#define BENCH_REPETITIONS 30 // The default number of timed repetitions of every benchmark.
+#define BENCH_WARMUP 3 // The default number of repetitions run before the timed ones, to warm the caches and the branch predictors.
+#define BENCH_MAX_RESULTS 64 // The most benchmarks in one run.
+#define BENCH_MAX_REPETITIONS 1000 // The most timed repetitions of a benchmark.
+#define BENCH_NOF_INPUTS 4096 // The number of random inputs prepared for a benchmark, used in a cycle. A power of 2.
+#define BENCH_MIN_HAND_SIZE 4 // The smallest hand of the hand size benchmarks.
+#define BENCH_MAX_HAND_SIZE 4096 // The biggest hand of the hand size benchmarks, the sizes grow by 4 times.
+#define BENCH_SEED 12345 // The seed of the benchmarks' random inputs, so every run times the same work.
+
+// Server
+#define SERVER_DEFAULT_ADDRESS "7777" // The address the server listens on when none is given: a TCP port, host:port, or the path of a Unix socket.
+#define SERVER_MAX_LOOPS 256 // The most event loops (threads) of a server, the loop's index is the low byte of every id.
+#define SERVER_MAX_EVENTS 256 // The most events an event loop handles in one wait.
+#define SERVER_READ_SIZE 16384 // How many bytes a connection reads at once.
+#define SERVER_MAX_LINE 256 // The longest line a client can send, a longer line closes the connection.
+#define SERVER_MAX_OUT_LINE 1024 // The longest line the server sends (a TURN line with the whole hand).
+#define SERVER_OUT_START_SIZE 1024 // The first size of a connection's output buffer, it doubles when it is full.
+#define SERVER_MAX_OUT_SIZE (1 << 22) // A client that doesn't read and lets this much output wait is disconnected.
+#define SERVER_LISTEN_BACKLOG 4096 // The length of the queue of connections waiting to be accepted.
+#define SERVER_ARENA_CHUNK_SIZE 2048 // The arena chunk of a table, big enough for the players and cards of a game of 4.
+#define SERVER_LISTEN_ID 0 // The epoll data of the listening socket, the ids of connections are never 0.
+#define SERVER_WAKE_ID 1 // The epoll data of a loop's eventfd, written when messages are posted to the loop.
+
+// Load generator
+#define LOAD_DEFAULT_SECONDS 10 // How long the load generator runs when no time is given.
+#define LOAD_MAX_LATENCY_US 100000 // Latencies of a move are counted in microseconds up to this, longer ones in the last bucket.
+
 
 // ---------- Data Stractures ----------
 
-// Card data containing its characteristics.
-typedef struct Card
+// The drawing of a card, CARD_LENGTH rows of CARD_WIDTH characters (without the ends of the lines).
+typedef struct Card_Glyph
+{
+    char rows[CARD_LENGTH][CARD_WIDTH];
+} CARD_GLYPH;
+
+// The text of a screen, composed in memory and written with a single write.
+typedef struct Frame
+{
+    char data[FRAME_BUFFER_SIZE]; // The characters of the frame.
+    size_t len; // The number of characters in the frame.
+} FRAME;
+
+// A character of the full screen mode's board and its color.
+typedef struct Screen_Cell
 {
-    char type[MAX_CARD_NAME_LEN]; // The possible type names are: "+" / "STOP" / "<->" / "COLOR" / "TAKI" / "NORMAL". ("NORMAL" is for the normal cards that have a number in them, other types are the special cards)
-    int num; // Containing a number from 1-9.
-    char color; // Each color is represented by the first character of its name: 'G' / 'R' / 'Y' / 'B'. (green/red/yellow/blue)
-} CARD;
+    char ch; // The character.
+    unsigned char color; // The color of the character (CARD_COLOR).
+} SCREEN_CELL;
 
-// Player data containing his name and an array of all the cards that in his possession.
-typedef struct Player
+// The full screen mode: the board being composed, the board that is already on the screen, and the frame the changes are written with.
+typedef struct Tui
+{
+    SCREEN_CELL* cells; // The composed board, nof_rows rows of nof_cols cells.
+    SCREEN_CELL* shown_cells; // The board on the screen, in the same size.
+    int nof_rows; // The number of rows of the board, the questions are below them.
+    int nof_cols; // The number of collums of the board.
+    FRAME frame; // The changes of the screen.
+} TUI;
+
+// A policy plugin loaded from a shared object (taki_policy.h).
+typedef struct Loaded_Policy
 {
-    char name[MAX_NAME_LEN]; // The name of the player. The maximum length of the name is MAX_NAME_LEN.
-    CARD* cards; // An array containing all the cards that belong to the player, the array is dynamic.
-    int nof_cards; // The number of cards that the player has. This is both the physical and logical size of the cards array.
-    int cards_phys_size; // The physical size of the cards array.
-} PLAYER;
+    void* handle; // The handle of the loaded shared object.
+    const TAKI_POLICY* policy_p; // The functions of the policy.
+    int nof_users; // How many games are playing with the policy now, it is unloaded only when no game uses it.
+} LOADED_POLICY;
 
-// Statistic data: The card number or type and the frequency of how many times that card was drawn.
-typedef struct Stat_Data
+// A seat of the simulation played by a policy plugin. The policy can be swapped between games, the games already playing keep the old policy.
+typedef struct Policy_Slot
 {
-    char card_type[MAX_CARD_NAME_LEN]; // If card is "NORMAL" type, we use the card_num.
-    int card_num;
-    int card_freq; // The number of times the card was drawn.
-} STAT_DATA;
+    const char* path; // The path of the shared object, NULL for a seat of the automatic player (Choose_Auto_Move).
+    LOADED_POLICY* current_p; // The policy new games use.
+    pthread_mutex_t mutex; // Protects the current policy and the numbers of users.
+} POLICY_SLOT;
 
-// Game data containing the players and the game's logic.
-typedef struct Game_Data
+// The policies of every seat of a game, and their states for the game.
+typedef struct Seat_Policies
 {
-    PLAYER* players; // Pointer to array of all the players in the game.
     int nof_players; // The number of players in the game.
-    int player_index; // The index of the player whose turn it is.
-    CARD top_card; // The card on the top of the deck.
-    bool is_direction_right; // True if the direction of the play is to the right, false if it is to the left.
-    bool is_game_won; // If the game has finished, one of the players dropped all his cards.
-    STAT_DATA stats[GAME_STATS_MAX_SIZE]; // Array of stats of all the cards drawn.
-    int nof_stats; // The number of stats currently in the stats array.
-} GAME_DATA;
+    POLICY_SLOT* slots; // The slots of the seats, the policies are returned to them at the end of the game.
+    LOADED_POLICY* policies[MAX_SIM_PLAYERS]; // The policy of every seat, NULL for the automatic player.
+    void* states[MAX_SIM_PLAYERS]; // The state of every seat's policy for the game.
+} SEAT_POLICIES;
+
+// The settings of a simulation of many games with automatic players.
+typedef struct Sim_Config
+{
+    long long nof_games; // The number of games to play.
+    int nof_players; // The number of players in every game.
+    int nof_threads; // The number of worker threads, 0 to use all the cores.
+    uint64_t seed; // The seed of all the games, every game uses its number as the stream.
+    bool is_finite_deck; // True to play with the standard finite deck, false to play with an infinite deck of random cards.
+    const char* log_path; // The log file all the games are appended to, NULL to not record the games.
+    const char* policy_paths[MAX_SIM_PLAYERS]; // The policy plugin of every seat, NULL for the automatic player.
+} SIM_CONFIG;
+
+// The results of simulated games, every worker has its own results and they are merged at the end.
+typedef struct Sim_Result
+{
+    unsigned long long nof_games; // The number of games played.
+    unsigned long long nof_turns; // The number of turns played in all the games.
+    int nof_players; // The number of players in every game.
+    unsigned long long seat_wins[MAX_SIM_PLAYERS]; // How many games every seat won.
+    unsigned long long card_freqs[NOF_CARD_CODES]; // How many times every card code was drawn in all the games.
+} SIM_RESULT;
+
+// The times of one benchmark, in nanoseconds per operation.
+typedef struct Bench_Result
+{
+    const char* name; // The name of the benchmark.
+    long long param; // The size the benchmark ran with (a hand size, a number of players), 0 if it has none.
+    long long ops_per_rep; // The number of operations in every timed repetition.
+    double min, p50, p90, p99, max, mean; // The time of one operation in the fastest, median, ... repetition.
+} BENCH_RESULT;
+
+// The results of all the benchmarks of a run, and its settings.
+typedef struct Bench_Suite
+{
+    BENCH_RESULT results[BENCH_MAX_RESULTS]; // The results, in the order the benchmarks ran.
+    int nof_results; // The number of results.
+    int repetitions; // The number of timed repetitions of every benchmark.
+    int warmup; // The number of untimed repetitions before them.
+} BENCH_SUITE;
+
+// The inputs and the game a benchmark works on, prepared before it is timed.
+typedef struct Bench_Context
+{
+    GAME_DATA game_data; // A game of 2 players with an infinite deck, player 1 plays the cards.
+    RNG rng; // The random numbers of the benchmark.
+    CARD cards[BENCH_NOF_INPUTS]; // The cards the benchmark plays or checks.
+    CARD top_cards[BENCH_NOF_INPUTS]; // The top cards they are played or checked on.
+    CARD_COLOR colors[BENCH_NOF_INPUTS]; // The colors chosen for the COLOR cards.
+    STAT_DATA stats[GAME_STATS_MAX_SIZE]; // Unsorted stats for the sorting benchmark.
+    int nof_stats; // The number of stats.
+    int hand_size; // The size of the hand for the hand size benchmarks.
+    ARENA arena; // The memory of the full games.
+    unsigned long long sink; // The results of the benchmarks are added here, so the compiler doesn't remove the timed work.
+} BENCH_CONTEXT;
+
+// A benchmark: runs the given number of operations on its context.
+typedef void (*BENCH_FUNC)(BENCH_CONTEXT* context_p, long long nof_ops);
+
+// The objects of an event loop (connections or tables), kept in slots that are reused after they are released.
+// The id of an object is its slot's generation (high 32 bits), its slot (24 bits) and its loop (low 8 bits), so a stale id is never found again.
+typedef struct Slot_Pool
+{
+    void** items; // The object of every slot, allocated once and kept when the slot is released.
+    uint32_t* generations; // The generation of every slot: odd while the slot is used, even while it is free.
+    int* free_slots; // A stack of the free slots.
+    int nof_free; // The number of free slots.
+    int nof_slots; // The number of slots ever used.
+    int phys_size; // The physical size of the arrays.
+    size_t item_size; // The size of an object.
+} SLOT_POOL;
+
+// The kinds of messages one event loop posts to another.
+typedef enum Server_Message_Kind
+{
+    SERVER_MSG_JOIN, // A connection asks to join a table.
+    SERVER_MSG_MOVE, // A connection plays a move at a table.
+    SERVER_MSG_LEAVE, // A connection leaves a table, or was closed.
+    SERVER_MSG_SEND // A line to send to a connection.
+} SERVER_MESSAGE_KIND;
+
+// A message between event loops. A table is changed only by its own loop, and a connection is written only by its own loop.
+typedef struct Server_Message
+{
+    struct Server_Message* next; // The next message of the inbox.
+    SERVER_MESSAGE_KIND kind; // What the message is.
+    uint64_t conn_id; // The connection.
+    uint64_t table_id; // The table. For SERVER_MSG_SEND, a table to remove from the connection's tables, or 0.
+    int value; // The move code of SERVER_MSG_MOVE.
+    int len; // The length of the line of SERVER_MSG_SEND.
+    char line[]; // The line of SERVER_MSG_SEND.
+} SERVER_MESSAGE;
+
+// A client connected to the server.
+typedef struct Server_Conn
+{
+    uint64_t id; // The id of the connection.
+    int fd; // The socket.
+    char in[SERVER_MAX_LINE]; // The start of a line that wasn't received whole yet.
+    int in_len; // The length of the partial line.
+    char* out; // The output waiting to be written, a dynamic array.
+    size_t out_pos; // The first byte of the output that wasn't written yet.
+    size_t out_len; // The number of bytes in the output.
+    size_t out_phys_size; // The physical size of the output.
+    bool is_dirty; // True while the connection is in its loop's list of connections to flush.
+    uint64_t* table_ids; // The tables the connection has seats at, they are left when the connection closes. A dynamic array.
+    int nof_tables; // The number of tables.
+    int tables_phys_size; // The physical size of the tables array.
+} SERVER_CONN;
+
+// A table: one game, played by connected clients and by the automatic player in the seats no client took.
+// The table is a state machine: it waits for its clients to join, then for the move of the client whose turn it is, and the automatic player's turns are played at once.
+typedef struct Server_Table
+{
+    uint64_t id; // The id of the table.
+    GAME_DATA game_data; // The game.
+    ARENA arena; // The memory of the game's players and cards, kept for the next game of the slot.
+    int nof_humans; // The number of seats played by clients, the first seats.
+    int nof_joined; // The number of clients that took a seat.
+    uint64_t seat_conns[MAX_SIM_PLAYERS]; // The connection of every seat, 0 for the automatic player.
+    bool is_started; // True once every client joined and the game began.
+} SERVER_TABLE;
+
+struct Server;
+
+// An event loop of the server, on its own thread. It owns the connections it accepted and the tables they opened.
+typedef struct Server_Loop
+{
+    int loop_i; // The index of the loop.
+    struct Server* server_p; // The server.
+    pthread_t thread; // The loop's thread (loop 0 runs on the main thread).
+    int epoll_fd; // The loop's epoll instance.
+    int wake_fd; // The eventfd written when messages are posted to the loop.
+    SLOT_POOL conns; // The connections of the loop.
+    SLOT_POOL tables; // The tables of the loop.
+    uint64_t* dirty_ids; // The connections with output to write at the end of this round of events. A dynamic array.
+    int nof_dirty; // The number of dirty connections.
+    int dirty_phys_size; // The physical size of the dirty array.
+    RNG rng; // The seeds of the tables that don't choose one.
+    pthread_mutex_t inbox_mutex; // Protects the inbox.
+    SERVER_MESSAGE* inbox_head; // The messages posted to the loop, oldest first.
+    SERVER_MESSAGE* inbox_tail; // The last message of the inbox.
+    unsigned long long nof_games; // The number of games that ended at the loop's tables.
+    unsigned long long nof_moves; // The number of moves played at the loop's tables.
+    unsigned long long nof_accepted; // The number of connections the loop accepted.
+} SERVER_LOOP;
+
+// The server: the listening socket and the event loops.
+typedef struct Server
+{
+    int listen_fd; // The listening socket, shared by all the loops.
+    int nof_loops; // The number of event loops.
+    SERVER_LOOP* loops; // The event loops.
+    atomic_bool is_stopping; // Set by SIGINT or SIGTERM, every loop stops at its next wake up.
+} SERVER;
+
+// The settings of the load generator.
+typedef struct Load_Config
+{
+    const char* address; // The address of the server.
+    int nof_threads; // The number of threads, every thread has its own event loop.
+    int nof_conns; // The number of connections of all the threads.
+    int nof_tables; // The number of tables every connection plays at once.
+    int nof_players; // The number of players at every table, the client plays seat 0 and the automatic player the rest.
+    double seconds; // How long to play.
+} LOAD_CONFIG;
+
+// A table of the load generator, waiting for the server's answer to its last move.
+typedef struct Load_Table
+{
+    uint64_t table_id; // The server's id of the table, 0 for an empty entry of the map.
+    struct timespec sent_time; // When the last move was sent.
+} LOAD_TABLE;
+
+// A connection of the load generator to the server.
+typedef struct Load_Conn
+{
+    int fd; // The socket.
+    char in[SERVER_MAX_OUT_LINE]; // The start of a line that wasn't received whole yet.
+    int in_len; // The length of the partial line.
+    char* out; // The lines waiting to be written, a dynamic array.
+    size_t out_len; // The number of bytes in the output.
+    size_t out_phys_size; // The physical size of the output.
+    LOAD_TABLE* tables; // The tables waiting for an answer, an open addressing map by id.
+    int tables_size; // The size of the map, a power of 2 at least twice the number of tables.
+} LOAD_CONN;
+
+// A thread of the load generator, and its results.
+typedef struct Load_Worker
+{
+    const LOAD_CONFIG* config_p; // The settings.
+    LOAD_CONN* conns; // The connections of the thread.
+    int nof_conns; // The number of connections.
+    pthread_t thread; // The thread.
+    unsigned long long nof_games; // The number of games finished.
+    unsigned long long nof_moves; // The number of moves the thread's clients played.
+    unsigned long long nof_errors; // The number of ERR lines received.
+    unsigned long long latency_counts[LOAD_MAX_LATENCY_US + 1]; // How many moves were answered after every number of microseconds.
+} LOAD_WORKER;
+
+// A worker thread of the simulation.
+typedef struct Sim_Worker
+{
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t range; // The range of games left for this worker, packed by Pack_Games_Range. Other workers steal from its back.
+    _Alignas(CACHE_LINE_SIZE) SIM_RESULT result; // The results of the games this worker played. Kept away from the range's cache line.
+    ARENA arena; // The memory of the games this worker plays, reset after every game.
+    GAME_LOG log; // The record of the game this worker plays, when the games are recorded.
+    LOG_WRITER* log_writer_p; // The log file of the simulation, shared by all the workers. NULL to not record the games.
+    POLICY_SLOT* policy_slots; // The policy slots of the seats, shared by all the workers. NULL if every seat is the automatic player.
+    pthread_t thread; // The thread running the worker.
+    int worker_i; // The index of the worker.
+    int nof_workers; // The number of workers.
+    struct Sim_Worker* workers; // All the workers, to steal games from.
+    SIM_CONFIG config; // The simulation's settings.
+} SIM_WORKER;
 
 
 // ---------------------- Print Functions -----------------------
 
 void Print_Welcome_Screen();
 
-void Print_Card(CARD card);
+void Print_Card(FRAME* frame_p, CARD card);
+
+void Draw_Card_Glyph(CARD_GLYPH* glyph_p, CARD card);
 
-void Print_Normal_Card(CARD card);
+void Draw_Normal_Card(CARD_GLYPH* glyph_p, CARD card);
 
-void Print_Special_Card(CARD card);
+void Draw_Special_Card(CARD_GLYPH* glyph_p, CARD card);
 
-void Print_Player_Cards(PLAYER player);
+void Print_Player_Cards(FRAME* frame_p, const PLAYER* player_p);
 
-void Print_Current_Deck(CARD top_card, PLAYER player);
+void Print_Current_Deck(CARD top_card, const PLAYER* player_p);
 
 void Print_Special_Card_Stat(STAT_DATA stat);
 
-void Print_Game_Stats(GAME_DATA game_data);
+void Print_Game_Stats(const GAME_DATA* game_data_p);
+
+void Print_Card_Stats(const unsigned long long card_freqs[]);
+
+char Get_Color_Char(int color_num);
 
 // ------------------ Game Setup Functions --------------------
 
@@ -112,72 +410,262 @@ void Set_Nof_Players(int* nof_players);
 
 void Set_Players_Names(PLAYER players_data[], int size);
 
-void Init_Game_Data(GAME_DATA* game_data_p);
+// -------------------- Gameplay Functions --------------------
+
+void Play_Game(GAME_DATA* game_data_p, TUI* tui_p, AI_PLAYER* ai_p);
 
-void Hand_Start_Cards(GAME_DATA* game_data_p, PLAYER players[], int nof_players);
+void Print_Computer_Move(const GAME_DATA* game_data_p, MOVE move);
 
-// ---------- Allocation and Initialization Functions ----------
+MOVE Choose_Human_Move(const GAME_DATA* game_data_p, void* context_p);
 
-void Init_Allocate_Players(GAME_DATA* game_data_p);
+CARD_COLOR Get_Color_Choice();
 
-void Init_Allocate_Players_Cards(GAME_DATA* game_data_p, int size);
+bool Check_Winner(const PLAYER* player_p);
 
-void Reallocate_Cards_Array(PLAYER* player_p, int size);
+int Find_Str_Mid_Index(const char str[]);
 
-void Free_Cards_Arrays(PLAYER players[], int nof_players);
+// -------------------- Simulation Functions ---------------------
 
-// -------------------- Randomize Functions ---------------------
+void Run_Simulation(const SIM_CONFIG* config_p);
 
-void Take_Random_Card(CARD* result_card_p);
+void* Sim_Worker_Thread(void* worker_vp);
 
-void Get_Random_Normal_Card(CARD* result_card_p);
+void Play_Sim_Game(SIM_WORKER* worker_p, uint32_t game_i);
 
-char Get_Random_Color();
+bool Take_Own_Game(SIM_WORKER* worker_p, uint32_t* game_i_p);
 
-char Get_Color_Char(int color_num);
+bool Steal_Games(SIM_WORKER* worker_p);
 
-// -------------------- Play Cards Functions --------------------
+uint64_t Pack_Games_Range(uint32_t first, uint32_t end);
 
-bool Check_Normal_Card(CARD normal_card, CARD top_card);
+void Unpack_Games_Range(uint64_t range, uint32_t* first_p, uint32_t* end_p);
 
-bool Check_Special_Card(CARD special_card, CARD top_card);
+void Init_Sim_Result(SIM_RESULT* result_p, int nof_players);
 
-bool Try_Play_Card(GAME_DATA* game_data_p, PLAYER* player_p, int card_i);
+void Merge_Sim_Result(SIM_RESULT* total_p, const SIM_RESULT* result_p);
 
-bool Play_Normal_Card(PLAYER* player_p, int card_i, CARD* top_card_p);
+void Print_Sim_Result(SIM_RESULT* result_p, int nof_threads, double seconds);
 
-void Play_Color_Card(PLAYER* player, int card_i);
+// ---------------------- Replay Functions -----------------------
 
-void Play_Stop_Card(GAME_DATA* game_data_p, PLAYER* player_p);
+bool Replay_Log_File(const char* path);
 
-void Play_Direction_Card(GAME_DATA* game_data_p);
+// ---------------------- Frame Functions -----------------------
 
-void Play_Taki_Card(GAME_DATA* game_data_p, PLAYER* player_p, int taki_card_i);
+void Frame_Init(FRAME* frame_p);
 
-void Play_Plus_Card(GAME_DATA* game_data_p, PLAYER* player_p, int card_i);
+void Frame_Append(FRAME* frame_p, const char* chars, size_t nof_chars);
 
-void Remove_Card_From_Array(PLAYER* player_p, int card_i, CARD* top_card_p);
+void Frame_Printf(FRAME* frame_p, const char* format, ...);
 
-void Draw_New_Card(GAME_DATA* game_data_p, PLAYER* player_p);
+void Frame_Flush(FRAME* frame_p);
 
-// -------------------- Gameplay Functions --------------------
+void Write_All(const char* chars, size_t nof_chars);
+
+// Add a character to the end of the frame.
+static inline void Frame_Put_Char(FRAME* frame_p, char c)
+{
+    if (frame_p->len == FRAME_BUFFER_SIZE)
+        Frame_Flush(frame_p);
+
+    frame_p->data[frame_p->len++] = c;
+}
+
+// Add a string to the end of the frame.
+static inline void Frame_Put_Str(FRAME* frame_p, const char* str) { Frame_Append(frame_p, str, strlen(str)); }
+
+// ---------------------- Glyph Functions -----------------------
+
+void Init_Card_Glyphs(void);
+
+const CARD_GLYPH* Get_Card_Glyph(CARD card);
+
+int Get_Screen_Width(void);
+
+// ---------------------- TUI Functions -----------------------
+
+extern const int ANSI_COLOR_CODES[NUM_OF_COLORS + 1]; // The ANSI color of every card color.
+
+void Tui_Init(TUI* tui_p);
+
+void Tui_Free(TUI* tui_p);
+
+void Tui_Clear(TUI* tui_p);
+
+void Tui_Put_Text(TUI* tui_p, int row, int col, const char* text, int len, CARD_COLOR color);
+
+void Tui_Put_Card(TUI* tui_p, int row, int col, CARD card);
+
+void Tui_Draw_Deck(TUI* tui_p, CARD top_card, const PLAYER* player_p);
+
+void Tui_Show(TUI* tui_p);
+
+bool Tui_Rewrite_Gap(TUI* tui_p, int row, int cursor_col, int col, int color);
+
+bool Replay_Log_File(const char* path);
+
+// ---------------------- Benchmark Functions -----------------------
+
+void Run_All_Benchmarks(BENCH_SUITE* suite_p);
+
+void Run_Benchmark(BENCH_SUITE* suite_p, const char* name, long long param, BENCH_FUNC bench_func, BENCH_CONTEXT* context_p, long long ops_per_rep);
+
+double Get_Percentile(const double sorted[], int nof_values, double percentile);
+
+int Compare_Doubles(const void* a_p, const void* b_p);
+
+void Print_Bench_Results(const BENCH_SUITE* suite_p);
+
+void Write_Bench_Json(const BENCH_SUITE* suite_p, FILE* file_p);
+
+void Bench_Init_Context(BENCH_CONTEXT* context_p);
+
+void Bench_Free_Context(BENCH_CONTEXT* context_p);
+
+void Bench_Fill_Hand(BENCH_CONTEXT* context_p, int nof_cards);
+
+void Bench_Take_Random_Card(BENCH_CONTEXT* context_p, long long nof_ops);
+
+void Bench_Check_Normal_Card(BENCH_CONTEXT* context_p, long long nof_ops);
+
+void Bench_Check_Special_Card(BENCH_CONTEXT* context_p, long long nof_ops);
+
+void Bench_Try_Play_Card(BENCH_CONTEXT* context_p, long long nof_ops);
+
+void Bench_Draw_New_Card(BENCH_CONTEXT* context_p, long long nof_ops);
+
+void Bench_Draw_Finite_Card(BENCH_CONTEXT* context_p, long long nof_ops);
+
+void Bench_Cards_Array_Growth(BENCH_CONTEXT* context_p, long long nof_ops);
+
+void Bench_Hand_Remove(BENCH_CONTEXT* context_p, long long nof_ops);
+
+void Bench_Update_Cards_Array(BENCH_CONTEXT* context_p, long long nof_ops);
+
+void Bench_Sort_Stats_Array(BENCH_CONTEXT* context_p, long long nof_ops);
+
+void Bench_Full_Games(BENCH_CONTEXT* context_p, long long nof_ops);
+
+// ---------------------- Policy Functions -----------------------
+
+LOADED_POLICY* Policy_Load(const char* path);
+
+void Policy_Unload(LOADED_POLICY* loaded_p);
+
+void Policy_Slot_Init(POLICY_SLOT* slot_p, const char* path);
+
+void Policy_Slot_Free(POLICY_SLOT* slot_p);
+
+bool Policy_Slot_Reload(POLICY_SLOT* slot_p);
+
+LOADED_POLICY* Policy_Slot_Acquire(POLICY_SLOT* slot_p);
+
+void Policy_Slot_Release(POLICY_SLOT* slot_p, LOADED_POLICY* loaded_p);
+
+void Seat_Policies_Begin(SEAT_POLICIES* seats_p, POLICY_SLOT slots[], int nof_players, uint64_t seed);
+
+void Seat_Policies_End(SEAT_POLICIES* seats_p);
+
+MOVE Choose_Seat_Move(const GAME_DATA* game_data_p, void* context_p);
+
+MOVE Choose_Policy_Move(const GAME_DATA* game_data_p, const TAKI_POLICY* policy_p, void* state);
+
+void Policy_Fill_View(const GAME_DATA* game_data_p, TAKI_POLICY_VIEW* view_p);
+
+void Policy_Request_Reload(int signal_num);
+
+bool Policy_Take_Reload_Request(void);
+
+// ---------------------- Server Functions -----------------------
+
+bool Run_Server(const char* address, int nof_loops);
+
+void* Server_Loop_Thread(void* loop_vp);
+
+void Server_Loop_Run(SERVER_LOOP* loop_p);
+
+void Server_Stop_Signal(int signal_num);
+
+int Open_Listen_Socket(const char* address);
+
+int Connect_Socket(const char* address);
+
+bool Parse_Socket_Address(const char* address, struct sockaddr_storage* addr_p, socklen_t* addr_len_p);
+
+void Slot_Pool_Init(SLOT_POOL* pool_p, size_t item_size);
+
+void* Slot_Pool_Acquire(SLOT_POOL* pool_p, int loop_i, uint64_t* id_p, bool* is_new_p);
+
+void* Slot_Pool_Get(const SLOT_POOL* pool_p, uint64_t id);
+
+void Slot_Pool_Release(SLOT_POOL* pool_p, uint64_t id);
+
+void Slot_Pool_Free(SLOT_POOL* pool_p, void (*free_item)(void* item));
+
+void Server_Post(SERVER_LOOP* loop_p, int target_loop_i, SERVER_MESSAGE* message_p);
+
+void Server_Drain_Inbox(SERVER_LOOP* loop_p);
+
+void Server_Send(SERVER_LOOP* loop_p, uint64_t conn_id, const char* line, int len, uint64_t done_table_id);
+
+void Server_To_Table(SERVER_LOOP* loop_p, SERVER_MESSAGE_KIND kind, uint64_t table_id, uint64_t conn_id, int value);
+
+void Conn_Accept(SERVER_LOOP* loop_p);
+
+void Conn_Read(SERVER_LOOP* loop_p, SERVER_CONN* conn_p);
+
+void Conn_Handle_Line(SERVER_LOOP* loop_p, SERVER_CONN* conn_p, char* line);
+
+void Conn_Write(SERVER_LOOP* loop_p, SERVER_CONN* conn_p, const char* chars, int len);
+
+bool Conn_Flush(SERVER_CONN* conn_p);
+
+void Conn_Close(SERVER_LOOP* loop_p, SERVER_CONN* conn_p);
+
+void Conn_Free(void* conn_vp);
+
+void Conn_Add_Table(SERVER_CONN* conn_p, uint64_t table_id);
+
+void Conn_Remove_Table(SERVER_CONN* conn_p, uint64_t table_id);
+
+void Table_Create(SERVER_LOOP* loop_p, SERVER_CONN* conn_p, int nof_players, int nof_humans, uint64_t seed);
+
+void Table_Join(SERVER_LOOP* loop_p, uint64_t table_id, uint64_t conn_id);
+
+void Table_Move(SERVER_LOOP* loop_p, uint64_t table_id, uint64_t conn_id, int move_code);
+
+void Table_Leave(SERVER_LOOP* loop_p, uint64_t table_id, uint64_t conn_id);
+
+void Table_Start(SERVER_LOOP* loop_p, SERVER_TABLE* table_p);
+
+void Table_Play_Move(SERVER_LOOP* loop_p, SERVER_TABLE* table_p, MOVE move);
+
+void Table_Advance(SERVER_LOOP* loop_p, SERVER_TABLE* table_p);
+
+void Table_Send_Turn(SERVER_LOOP* loop_p, const SERVER_TABLE* table_p);
+
+void Table_Broadcast(SERVER_LOOP* loop_p, const SERVER_TABLE* table_p, const char* line, int len, uint64_t done_table_id);
+
+void Table_Close(SERVER_LOOP* loop_p, SERVER_TABLE* table_p);
+
+void Table_Free(void* table_vp);
 
-void Play_Game(GAME_DATA* game_data_p);
+// ---------------------- Load Generator Functions -----------------------
 
-bool Check_Winner(PLAYER player);
+bool Run_Load(const LOAD_CONFIG* config_p);
 
-int Find_Str_Mid_Index(char str[]);
+void* Load_Worker_Thread(void* worker_vp);
 
-// ------------------- Statistics Functions --------------------
+void Load_Send(LOAD_CONN* conn_p, const char* chars, int len);
 
-void Add_Game_Stat(GAME_DATA* game_data_p, CARD card);
+bool Load_Flush(LOAD_CONN* conn_p);
 
-void Check_Stat_Normal_Card(GAME_DATA* game_data_p, CARD card);
+void Load_Handle_Line(LOAD_WORKER* worker_p, LOAD_CONN* conn_p, char* line);
 
-void Check_Stat_Special_Card(GAME_DATA* game_data_p, CARD card);
+LOAD_TABLE* Load_Find_Table(LOAD_CONN* conn_p, uint64_t table_id, bool is_adding);
 
-void Sort_Stats_Array(GAME_DATA* game_data_p);
+void Load_Remove_Table(LOAD_CONN* conn_p, uint64_t table_id);
 
-void Swap_Stats(STAT_DATA stats[], int first_i, int second_i);
+double Load_Latency_Percentile(const unsigned long long latency_counts[], double percentile);
 
 #endif // HEADER_H end if.
\ No newline at end of file
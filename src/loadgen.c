@@ -0,0 +1,395 @@
+#include "header.h"
+
+// The load generator: many clients on a few threads play games on a server as fast as it answers.
+// Every connection keeps the same number of tables open, the client plays seat 0 of each with the automatic player's first choice,
+// and opens a new table when a game ends. The latency of a move is the time from sending it to getting the next turn (or the end of the game).
+
+// -------------------- Load Generator Functions ---------------------
+
+/*
+ * Run the load generator, and print the games and moves per second and the latencies of the moves.
+ * Receives a pointer to the settings.
+ * Returns true if the load ran, false if it couldn't connect to the server.
+ */
+bool Run_Load(const LOAD_CONFIG* config_p)
+{
+    LOAD_WORKER* workers; // The threads.
+    LOAD_WORKER* total_p; // The results of all the threads, in the first worker.
+    int nof_threads = config_p->nof_threads > 0 ? config_p->nof_threads : (int) sysconf(_SC_NPROCESSORS_ONLN); // The number of threads.
+    bool is_connected = true; // False if a connection failed.
+
+    if (nof_threads > config_p->nof_conns)
+        nof_threads = config_p->nof_conns;
+
+    workers = (LOAD_WORKER*) calloc(nof_threads, sizeof(LOAD_WORKER));
+    if (workers == NULL)
+    {
+        printf("Memory allocation failed!!!\n");
+        exit(1);
+    }
+
+    // Connect all the clients before the time starts. The connections are split between the threads.
+    for (int worker_i = 0; worker_i < nof_threads && is_connected; worker_i++)
+    {
+        LOAD_WORKER* worker_p = &workers[worker_i]; // The thread.
+
+        worker_p->config_p = config_p;
+        worker_p->nof_conns = config_p->nof_conns / nof_threads + (worker_i < config_p->nof_conns % nof_threads);
+        worker_p->conns = (LOAD_CONN*) calloc(worker_p->nof_conns, sizeof(LOAD_CONN));
+        if (worker_p->conns == NULL)
+        {
+            printf("Memory allocation failed!!!\n");
+            exit(1);
+        }
+
+        for (int conn_i = 0; conn_i < worker_p->nof_conns; conn_i++)
+        {
+            LOAD_CONN* conn_p = &worker_p->conns[conn_i]; // The connection.
+
+            conn_p->fd = Connect_Socket(config_p->address);
+            if (conn_p->fd < 0)
+            {
+                printf("Can't connect to %s!!!\n", config_p->address);
+                is_connected = false;
+                worker_p->nof_conns = conn_i;
+                break;
+            }
+
+            // The map of the tables has at least twice as many entries as tables.
+            conn_p->tables_size = 4;
+            while (conn_p->tables_size < 2 * config_p->nof_tables)
+                conn_p->tables_size *= 2;
+            conn_p->tables = (LOAD_TABLE*) calloc(conn_p->tables_size, sizeof(LOAD_TABLE));
+            if (conn_p->tables == NULL)
+            {
+                printf("Memory allocation failed!!!\n");
+                exit(1);
+            }
+        }
+    }
+
+    if (is_connected)
+    {
+        printf("Playing on %s: %d connections of %d tables of %d players, %d threads, %.1f seconds\n", config_p->address, config_p->nof_conns,
+               config_p->nof_tables, config_p->nof_players, nof_threads, config_p->seconds);
+        fflush(stdout);
+
+        for (int worker_i = 0; worker_i < nof_threads; worker_i++)
+            if (pthread_create(&workers[worker_i].thread, NULL, Load_Worker_Thread, &workers[worker_i]) != 0)
+            {
+                printf("Creating the load threads failed!!!\n");
+                exit(1);
+            }
+        for (int worker_i = 0; worker_i < nof_threads; worker_i++)
+            pthread_join(workers[worker_i].thread, NULL);
+
+        // Merge the results into the first worker.
+        total_p = &workers[0];
+        for (int worker_i = 1; worker_i < nof_threads; worker_i++)
+        {
+            total_p->nof_games += workers[worker_i].nof_games;
+            total_p->nof_moves += workers[worker_i].nof_moves;
+            total_p->nof_errors += workers[worker_i].nof_errors;
+            for (int latency_i = 0; latency_i <= LOAD_MAX_LATENCY_US; latency_i++)
+                total_p->latency_counts[latency_i] += workers[worker_i].latency_counts[latency_i];
+        }
+
+        printf("\n************ Load Results ************\n");
+        printf("Games: %llu, Moves: %llu, Errors: %llu, Tables: %d\n", total_p->nof_games, total_p->nof_moves, total_p->nof_errors,
+               config_p->nof_conns * config_p->nof_tables);
+        printf("%.0f games/sec, %.0f moves/sec\n", total_p->nof_games / config_p->seconds, total_p->nof_moves / config_p->seconds);
+        printf("Move latency (us): p50 %.0f, p90 %.0f, p99 %.0f, p99.9 %.0f, max %.0f\n",
+               Load_Latency_Percentile(total_p->latency_counts, 0.5), Load_Latency_Percentile(total_p->latency_counts, 0.9),
+               Load_Latency_Percentile(total_p->latency_counts, 0.99), Load_Latency_Percentile(total_p->latency_counts, 0.999),
+               Load_Latency_Percentile(total_p->latency_counts, 1.0));
+    }
+
+    // Close the connections, the server closes their tables.
+    for (int worker_i = 0; worker_i < nof_threads; worker_i++)
+    {
+        for (int conn_i = 0; conn_i < workers[worker_i].nof_conns; conn_i++)
+        {
+            close(workers[worker_i].conns[conn_i].fd);
+            free(workers[worker_i].conns[conn_i].out);
+            free(workers[worker_i].conns[conn_i].tables);
+        }
+        free(workers[worker_i].conns);
+    }
+    free(workers);
+
+    return is_connected;
+}
+
+
+/*
+ * A thread of the load generator: opens the tables of its connections, and plays them until the time is over.
+ * Receives a pointer to the worker.
+ * Returns NULL.
+ */
+void* Load_Worker_Thread(void* worker_vp)
+{
+    LOAD_WORKER* worker_p = (LOAD_WORKER*) worker_vp; // The worker.
+    const LOAD_CONFIG* config_p = worker_p->config_p; // The settings.
+    struct epoll_event events[SERVER_MAX_EVENTS]; // The events of one wait.
+    struct epoll_event event; // The registration of a connection.
+    struct timespec start_time, now; // When the load started, and the time now.
+    char line[SERVER_MAX_LINE]; // A line to the server.
+    char buffer[SERVER_READ_SIZE]; // The bytes read.
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC); // The thread's epoll instance.
+    int nof_events; // The number of events of a wait.
+
+    if (epoll_fd < 0)
+    {
+        printf("Creating the epoll instance failed!!!\n");
+        exit(1);
+    }
+
+    // Open the tables.
+    for (int conn_i = 0; conn_i < worker_p->nof_conns; conn_i++)
+    {
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.ptr = &worker_p->conns[conn_i];
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, worker_p->conns[conn_i].fd, &event);
+
+        for (int table_i = 0; table_i < config_p->nof_tables; table_i++)
+            Load_Send(&worker_p->conns[conn_i], line, snprintf(line, sizeof(line), "NEW %d 1\n", config_p->nof_players));
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    now = start_time;
+    while ((now.tv_sec - start_time.tv_sec) + (now.tv_nsec - start_time.tv_nsec) / 1e9 < config_p->seconds)
+    {
+        // Write what the clients sent, then wait for the answers.
+        for (int conn_i = 0; conn_i < worker_p->nof_conns; conn_i++)
+            if (!Load_Flush(&worker_p->conns[conn_i]))
+            {
+                printf("The server closed a connection!!!\n");
+                return NULL;
+            }
+
+        nof_events = epoll_wait(epoll_fd, events, SERVER_MAX_EVENTS, 100);
+        for (int event_i = 0; event_i < nof_events; event_i++)
+        {
+            LOAD_CONN* conn_p = (LOAD_CONN*) events[event_i].data.ptr; // The connection of the event.
+            ssize_t nof_read; // The number of bytes read.
+
+            while ((nof_read = recv(conn_p->fd, buffer, sizeof(buffer), 0)) > 0)
+                for (ssize_t byte_i = 0; byte_i < nof_read; byte_i++)
+                {
+                    if (buffer[byte_i] != '\n')
+                    {
+                        if (conn_p->in_len < SERVER_MAX_OUT_LINE - 1)
+                            conn_p->in[conn_p->in_len++] = buffer[byte_i];
+                        continue;
+                    }
+                    conn_p->in[conn_p->in_len] = '\0';
+                    conn_p->in_len = 0;
+                    Load_Handle_Line(worker_p, conn_p, conn_p->in);
+                }
+
+            if (nof_read == 0 || (nof_read < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+            {
+                printf("The server closed a connection!!!\n");
+                return NULL;
+            }
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    }
+
+    close(epoll_fd);
+
+    return NULL;
+}
+
+
+/*
+ * Add a line to the output of a connection, it is written before the next wait.
+ * Receives a pointer to the connection, the characters and their number.
+ */
+void Load_Send(LOAD_CONN* conn_p, const char* chars, int len)
+{
+    if (conn_p->out_len + len > conn_p->out_phys_size)
+    {
+        size_t new_size = conn_p->out_phys_size == 0 ? SERVER_OUT_START_SIZE : conn_p->out_phys_size * 2; // The new physical size.
+        char* new_out; // The grown buffer.
+
+        while (new_size < conn_p->out_len + len)
+            new_size *= 2;
+        new_out = (char*) realloc(conn_p->out, new_size);
+        if (new_out == NULL)
+        {
+            printf("Memory allocation failed!!!\n");
+            exit(1);
+        }
+        conn_p->out = new_out;
+        conn_p->out_phys_size = new_size;
+    }
+
+    memcpy(&conn_p->out[conn_p->out_len], chars, len);
+    conn_p->out_len += len;
+}
+
+
+/*
+ * Write as much of a connection's output as the socket takes, the rest is moved to the start of the buffer.
+ * Receives a pointer to the connection.
+ * Returns false if the connection failed, true otherwise.
+ */
+bool Load_Flush(LOAD_CONN* conn_p)
+{
+    size_t nof_written = 0; // The number of bytes written.
+    ssize_t nof_sent; // The number of bytes of one send.
+
+    while (nof_written < conn_p->out_len)
+    {
+        nof_sent = send(conn_p->fd, &conn_p->out[nof_written], conn_p->out_len - nof_written, MSG_NOSIGNAL);
+        if (nof_sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                return false;
+            break;
+        }
+        nof_written += nof_sent;
+    }
+
+    memmove(conn_p->out, &conn_p->out[nof_written], conn_p->out_len - nof_written);
+    conn_p->out_len -= nof_written;
+
+    return true;
+}
+
+
+/*
+ * Handle a line of the server: play the client's turn, count the latency of its last move, and open a new table when a game ends.
+ * Receives a pointer to the worker, the connection, and the line (without its '\n').
+ */
+void Load_Handle_Line(LOAD_WORKER* worker_p, LOAD_CONN* conn_p, char* line)
+{
+    char move_line[SERVER_MAX_LINE]; // The line to the server.
+    unsigned long long table_id, move_codes; // The table of the line, and the legal moves of a turn.
+    int top_card, is_taki_open; // The rest of a turn, unused.
+    LOAD_TABLE* table_p; // The table waiting for an answer.
+    struct timespec now; // The time the line was handled.
+    bool is_turn; // True for a turn, false for the end of a game.
+
+    if (!strncmp(line, "ERR", 3))
+    {
+        worker_p->nof_errors++;
+        return;
+    }
+
+    is_turn = !strncmp(line, "TURN ", 5) && sscanf(line + 5, "%llu %d %d %llx", &table_id, &top_card, &is_taki_open, &move_codes) == 4;
+    if (!is_turn && !(!strncmp(line, "WIN ", 4) && sscanf(line + 4, "%llu", &table_id) == 1))
+        return; // SEAT, START and the moves of the other seats.
+
+    // The latency of the client's last move at the table.
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    table_p = Load_Find_Table(conn_p, table_id, is_turn);
+    if (table_p != NULL && table_p->sent_time.tv_sec != 0)
+    {
+        long long latency_us = (now.tv_sec - table_p->sent_time.tv_sec) * 1000000LL + (now.tv_nsec - table_p->sent_time.tv_nsec) / 1000; // The latency.
+
+        worker_p->latency_counts[latency_us < LOAD_MAX_LATENCY_US ? latency_us : LOAD_MAX_LATENCY_US]++;
+    }
+
+    if (!is_turn)
+    {
+        Load_Remove_Table(conn_p, table_id);
+        worker_p->nof_games++;
+        Load_Send(conn_p, move_line, snprintf(move_line, sizeof(move_line), "NEW %d 1\n", worker_p->config_p->nof_players));
+        return;
+    }
+
+    // Play the lowest move code: the lowest card that can be dropped, or else drawing a card or closing the TAKI sequence.
+    table_p->sent_time = now;
+    worker_p->nof_moves++;
+    Load_Send(conn_p, move_line, snprintf(move_line, sizeof(move_line), "MOVE %llu %d\n", table_id, __builtin_ctzll(move_codes)));
+}
+
+
+/*
+ * Find a table in the map of a connection, by linear probing from the table's hash.
+ * Receives a pointer to the connection, the table's id, and true to add the table if it isn't in the map.
+ * Returns the table's entry, or NULL if it isn't in the map and wasn't added.
+ */
+LOAD_TABLE* Load_Find_Table(LOAD_CONN* conn_p, uint64_t table_id, bool is_adding)
+{
+    int mask = conn_p->tables_size - 1; // The mask of the map's indexes.
+    int table_i = (int) ((table_id * 0x9E3779B97F4A7C15ULL) >> 40) & mask; // The entry the search starts at.
+
+    while (conn_p->tables[table_i].table_id != 0)
+    {
+        if (conn_p->tables[table_i].table_id == table_id)
+            return &conn_p->tables[table_i];
+        table_i = (table_i + 1) & mask;
+    }
+
+    if (!is_adding)
+        return NULL;
+
+    conn_p->tables[table_i].table_id = table_id;
+    conn_p->tables[table_i].sent_time.tv_sec = 0;
+    conn_p->tables[table_i].sent_time.tv_nsec = 0;
+
+    return &conn_p->tables[table_i];
+}
+
+
+/*
+ * Remove a table from the map of a connection. The entries after it move back, so every search still finds its table.
+ * Receives a pointer to the connection and the table's id.
+ */
+void Load_Remove_Table(LOAD_CONN* conn_p, uint64_t table_id)
+{
+    int mask = conn_p->tables_size - 1; // The mask of the map's indexes.
+    LOAD_TABLE* table_p = Load_Find_Table(conn_p, table_id, false); // The removed entry.
+    int hole_i, next_i; // The empty entry, and the entry checked after it.
+
+    if (table_p == NULL)
+        return;
+
+    hole_i = (int) (table_p - conn_p->tables);
+    for (next_i = (hole_i + 1) & mask; conn_p->tables[next_i].table_id != 0; next_i = (next_i + 1) & mask)
+    {
+        int home_i = (int) ((conn_p->tables[next_i].table_id * 0x9E3779B97F4A7C15ULL) >> 40) & mask; // Where the entry's search starts.
+
+        // Move the entry into the hole if its search passes through the hole.
+        if (((next_i - home_i) & mask) >= ((next_i - hole_i) & mask))
+        {
+            conn_p->tables[hole_i] = conn_p->tables[next_i];
+            hole_i = next_i;
+        }
+    }
+    conn_p->tables[hole_i].table_id = 0;
+}
+
+
+/*
+ * Find a percentile of the latencies.
+ * Receives the number of moves of every latency in microseconds, and the percentile (0-1).
+ * Returns the latency in microseconds, 0 if no latency was counted.
+ */
+double Load_Latency_Percentile(const unsigned long long latency_counts[], double percentile)
+{
+    unsigned long long nof_counted = 0, rank, seen = 0; // The number of latencies, the rank of the percentile, and the latencies passed.
+
+    for (int latency_i = 0; latency_i <= LOAD_MAX_LATENCY_US; latency_i++)
+        nof_counted += latency_counts[latency_i];
+    if (nof_counted == 0)
+        return 0;
+
+    rank = (unsigned long long) ceil(percentile * nof_counted);
+    if (rank == 0)
+        rank = 1;
+    for (int latency_i = 0; latency_i <= LOAD_MAX_LATENCY_US; latency_i++)
+    {
+        seen += latency_counts[latency_i];
+        if (seen >= rank)
+            return latency_i;
+    }
+
+    return LOAD_MAX_LATENCY_US;
+}
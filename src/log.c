@@ -0,0 +1,461 @@
+#include "header.h"
+
+// -------------------- Game Log Functions ---------------------
+// An append-only binary log of games. The log file starts with LOG_MAGIC, then has one record for every game:
+//   varint  the length of the record (without this varint)
+//   varint  seed, varint stream, varint number of players
+//   byte    the deck: LOG_DECK_INFINITE / LOG_DECK_STANDARD / LOG_DECK_CUSTOM (then a count byte for the card codes 0 to FIRST_COLOR_CODE)
+//   byte    the first top card
+//   deal    for every player: varint number of cards, then a byte for every card code of his start hand
+//   moves   a byte for every move, see Log_Encode_Move, in the order they were applied
+//   byte    LOG_GAME_END, then varint the index of the winner
+// The players, the turns and the drawn cards aren't logged, replaying the moves with the seed and the stream gives them again.
+// A record is written with a single write when the game ends, so several threads and processes can append to the same file.
+
+/*
+ * Open a log file for appending games. A new file gets the log's magic first.
+ * Receives a pointer to the log writer and the path of the log file.
+ * Returns true if the file was opened, false otherwise.
+ */
+bool Log_Open_Writer(LOG_WRITER* writer_p, const char* path)
+{
+    struct stat file_stat; // The size of the file, to know if it is new.
+
+    writer_p->fd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (writer_p->fd < 0)
+        return false;
+
+    // Start a new log with the magic.
+    if (fstat(writer_p->fd, &file_stat) == 0 && file_stat.st_size == 0)
+        if (write(writer_p->fd, LOG_MAGIC, LOG_MAGIC_LEN) != LOG_MAGIC_LEN)
+            return false;
+
+    return true;
+}
+
+
+/*
+ * Close a log file opened by Log_Open_Writer.
+ * Receives a pointer to the log writer.
+ */
+void Log_Close_Writer(LOG_WRITER* writer_p)
+{
+    close(writer_p->fd);
+    writer_p->fd = EMPTY;
+}
+
+
+/*
+ * Initialize the log of games of one thread. The log's buffer grows to the size of the longest game, and is kept between games.
+ * Receives a pointer to the game log and the log writer its games are written to.
+ */
+void Log_Init(GAME_LOG* log_p, LOG_WRITER* writer_p)
+{
+    log_p->writer_p = writer_p;
+    log_p->data = NULL;
+    log_p->len = 0;
+    log_p->phys_size = 0;
+}
+
+
+/*
+ * Free the buffer of a game log.
+ * Receives a pointer to the game log.
+ */
+void Log_Free(GAME_LOG* log_p)
+{
+    free(log_p->data);
+    log_p->data = NULL;
+    log_p->phys_size = 0;
+}
+
+
+/*
+ * Start the record of a game that was just initialized: its settings and its deal. The game's moves are added by the engine from now on.
+ * Receives a pointer to the game log and a pointer to the game's data, before any move was applied.
+ */
+void Log_Begin_Game(GAME_LOG* log_p, GAME_DATA* game_data_p)
+{
+    const unsigned char* deck_counts = game_data_p->deck.counts; // The composition of the deck, NULL for an infinite deck.
+    CARD cards[MAX_DECK_SIZE]; // The cards of a player's start hand.
+
+    // Leave room for the length of the record, it is known only when the game ends.
+    log_p->len = 0;
+    for (int byte_i = 0; byte_i < MAX_VARINT_LEN; byte_i++)
+        Log_Put_Byte(log_p, 0);
+
+    Log_Put_Varint(log_p, game_data_p->seed);
+    Log_Put_Varint(log_p, game_data_p->stream);
+    Log_Put_Varint(log_p, (uint64_t) game_data_p->nof_players);
+
+    // The deck, the standard deck is logged without its composition.
+    if (deck_counts == NULL)
+        Log_Put_Byte(log_p, LOG_DECK_INFINITE);
+    else if (deck_counts == STANDARD_DECK_COUNTS)
+        Log_Put_Byte(log_p, LOG_DECK_STANDARD);
+    else
+    {
+        Log_Put_Byte(log_p, LOG_DECK_CUSTOM);
+        for (int card = 0; card <= FIRST_COLOR_CODE; card++)
+            Log_Put_Byte(log_p, deck_counts[card]);
+    }
+
+    // The deal: the first top card and the start hand of every player.
+    Log_Put_Byte(log_p, game_data_p->top_card);
+    for (int player_i = 0; player_i < game_data_p->nof_players; player_i++)
+    {
+        int nof_cards = Hand_Get_Cards(&game_data_p->players[player_i].hand, cards); // The number of cards the player got.
+
+        Log_Put_Varint(log_p, (uint64_t) nof_cards);
+        for (int card_i = 0; card_i < nof_cards; card_i++)
+            Log_Put_Byte(log_p, cards[card_i]);
+    }
+
+    game_data_p->log_p = log_p; // The engine logs the moves of the game.
+}
+
+
+/*
+ * Add a move to the record of the game. Called by the engine for every move it applies.
+ * Receives a pointer to the game log, the move and if a TAKI sequence was open when the move was chosen.
+ */
+void Log_Move(GAME_LOG* log_p, MOVE move, bool is_taki_open)
+{
+    Log_Put_Byte(log_p, Log_Encode_Move(move, is_taki_open));
+}
+
+
+/*
+ * Finish the record of the game with its winner, and append it to the log file with a single write.
+ * Receives a pointer to the game log and the index of the winner.
+ */
+void Log_End_Game(GAME_LOG* log_p, int winner_index)
+{
+    unsigned char len_bytes[MAX_VARINT_LEN]; // The length of the record, as a varint.
+    int nof_len_bytes; // The number of bytes of the length.
+    size_t start; // Where the record starts in the buffer, right before the length.
+
+    Log_Put_Byte(log_p, LOG_GAME_END);
+    Log_Put_Varint(log_p, (uint64_t) winner_index);
+
+    // Put the length right before the record, in the room that was left for it.
+    nof_len_bytes = Encode_Varint(log_p->len - MAX_VARINT_LEN, len_bytes);
+    start = MAX_VARINT_LEN - nof_len_bytes;
+    memcpy(&log_p->data[start], len_bytes, nof_len_bytes);
+
+    if (log_p->writer_p != NULL)
+        if (write(log_p->writer_p->fd, &log_p->data[start], log_p->len - start) < 0)
+            printf("Writing the game log failed!!!\n");
+
+    log_p->len = 0;
+}
+
+
+/*
+ * Encode a move in one byte:
+ * a card code (0 to FIRST_COLOR_CODE) for a dropped card, FIRST_COLOR_CODE + color for a COLOR card dropped with a chosen color,
+ * LOG_DRAW for drawing a card and LOG_END_TAKI for closing a TAKI sequence.
+ * Receives the move and if a TAKI sequence was open (a COLOR card in a TAKI sequence has no chosen color).
+ * Returns the byte of the move.
+ */
+unsigned char Log_Encode_Move(MOVE move, bool is_taki_open)
+{
+    switch (move.kind)
+    {
+        case MOVE_DRAW:
+            return LOG_DRAW;
+
+        case MOVE_END_TAKI:
+            return LOG_END_TAKI;
+
+        default: // MOVE_PLAY
+            if (Get_Card_Type(move.card) == TYPE_COLOR && !is_taki_open)
+                return (unsigned char) Make_Card(TYPE_COLOR, move.color, EMPTY); // The COLOR card codes with a color are never in a hand.
+            return move.card;
+    }
+}
+
+
+/*
+ * Decode a move encoded by Log_Encode_Move.
+ * Receives the byte of the move.
+ * Returns the move.
+ */
+MOVE Log_Decode_Move(unsigned char move_byte)
+{
+    MOVE move; // The result move.
+
+    move.card = 0;
+    move.color = COLOR_NONE;
+
+    if (move_byte == LOG_DRAW)
+        move.kind = MOVE_DRAW;
+    else if (move_byte == LOG_END_TAKI)
+        move.kind = MOVE_END_TAKI;
+    else
+    {
+        move.kind = MOVE_PLAY;
+        move.card = move_byte;
+
+        // A COLOR card with a chosen color is the COLOR card of the hand.
+        if (Get_Card_Type(move_byte) == TYPE_COLOR)
+        {
+            move.card = Make_Card(TYPE_COLOR, COLOR_NONE, EMPTY);
+            move.color = Get_Card_Color(move_byte);
+        }
+    }
+
+    return move;
+}
+
+
+/*
+ * Add a byte to the record of the game. The buffer grows by doubling when it is full.
+ * Receives a pointer to the game log and the byte.
+ * If the allocation failed, prints error message and ends the program.
+ */
+void Log_Put_Byte(GAME_LOG* log_p, unsigned char byte)
+{
+    // Check if the buffer is full, then double its size.
+    if (log_p->len == log_p->phys_size)
+    {
+        log_p->phys_size = log_p->phys_size ? log_p->phys_size * 2 : LOG_BUFFER_START_SIZE;
+        log_p->data = (unsigned char*) realloc(log_p->data, log_p->phys_size);
+
+        // Check if the allocation failed.
+        if (log_p->data == NULL)
+        {
+            printf("Memory allocation failed!!!\n");
+            exit(1); // Stop the program.
+        }
+    }
+
+    log_p->data[log_p->len++] = byte;
+}
+
+
+/*
+ * Add a varint to the record of the game.
+ * Receives a pointer to the game log and the number.
+ */
+void Log_Put_Varint(GAME_LOG* log_p, uint64_t value)
+{
+    unsigned char bytes[MAX_VARINT_LEN]; // The bytes of the varint.
+    int nof_bytes = Encode_Varint(value, bytes); // The number of bytes of the varint.
+
+    for (int byte_i = 0; byte_i < nof_bytes; byte_i++)
+        Log_Put_Byte(log_p, bytes[byte_i]);
+}
+
+
+/*
+ * Encode a number as a varint: 7 bits in every byte from the lowest bits, the high bit is set in every byte except the last.
+ * Receives the number and an array for the bytes, with room for MAX_VARINT_LEN bytes.
+ * Returns the number of bytes.
+ */
+int Encode_Varint(uint64_t value, unsigned char bytes[])
+{
+    int nof_bytes = 0; // The number of bytes written.
+
+    while (value >= 0x80)
+    {
+        bytes[nof_bytes++] = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    bytes[nof_bytes++] = (unsigned char) value;
+
+    return nof_bytes;
+}
+
+
+/*
+ * Decode a varint.
+ * Receives a pointer to the position of the varint (moved to after it), the end of the data and a pointer where the number will be saved.
+ * Returns false if the data ended before the varint.
+ */
+bool Decode_Varint(const unsigned char** pos_p, const unsigned char* end, uint64_t* value_p)
+{
+    uint64_t value = 0; // The decoded number.
+
+    for (int shift = 0; shift < 64 && *pos_p < end; shift += 7)
+    {
+        unsigned char byte = *(*pos_p)++; // The next byte of the varint.
+
+        value |= (uint64_t) (byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            *value_p = value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+
+// -------------------- Log Reader Functions ---------------------
+// The reader maps the whole log file into memory, and reads the records in place, without copying them.
+
+/*
+ * Open a log file for reading, and check its magic.
+ * Receives a pointer to the log reader and the path of the log file.
+ * Returns true if the file was opened and is a log of games, false otherwise.
+ */
+bool Log_Open_Reader(LOG_READER* reader_p, const char* path)
+{
+    struct stat file_stat; // The size of the file.
+    int fd = open(path, O_RDONLY); // The log file.
+
+    reader_p->data = NULL;
+    reader_p->size = 0;
+
+    if (fd < 0)
+        return false;
+
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size < LOG_MAGIC_LEN)
+    {
+        close(fd);
+        return false;
+    }
+
+    // Map the file, the mapping stays after the file is closed.
+    reader_p->size = (size_t) file_stat.st_size;
+    reader_p->data = (const unsigned char*) mmap(NULL, reader_p->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (reader_p->data == MAP_FAILED || memcmp(reader_p->data, LOG_MAGIC, LOG_MAGIC_LEN) != 0)
+    {
+        if (reader_p->data != MAP_FAILED)
+            munmap((void*) reader_p->data, reader_p->size);
+        reader_p->data = NULL;
+        return false;
+    }
+
+    madvise((void*) reader_p->data, reader_p->size, MADV_SEQUENTIAL);
+    reader_p->pos = reader_p->data + LOG_MAGIC_LEN;
+
+    return true;
+}
+
+
+/*
+ * Unmap a log file opened by Log_Open_Reader.
+ * Receives a pointer to the log reader.
+ */
+void Log_Close_Reader(LOG_READER* reader_p)
+{
+    if (reader_p->data != NULL)
+        munmap((void*) reader_p->data, reader_p->size);
+    reader_p->data = NULL;
+}
+
+
+/*
+ * Read the next game of the log. The game's deal and moves point into the mapped file.
+ * Receives a pointer to the log reader and a pointer where the game is saved.
+ * Returns true if a game was read, false at the end of the log or if the record is broken (then the reader stays at the broken record).
+ */
+bool Log_Next_Game(LOG_READER* reader_p, LOGGED_GAME* game_p)
+{
+    const unsigned char* end = reader_p->data + reader_p->size; // The end of the log.
+    const unsigned char* pos = reader_p->pos; // The position in the log.
+    uint64_t record_len, nof_players, value; // The length of the record, and the numbers read from it.
+
+    if (!Decode_Varint(&pos, end, &record_len) || record_len > (uint64_t) (end - pos))
+        return false;
+
+    end = pos + record_len; // Read only inside the record.
+
+    if (!Decode_Varint(&pos, end, &game_p->seed) || !Decode_Varint(&pos, end, &game_p->stream) || !Decode_Varint(&pos, end, &nof_players)
+        || nof_players < 2 || nof_players > MAX_SIM_PLAYERS || pos >= end)
+        return false;
+    game_p->nof_players = (int) nof_players;
+
+    // The deck.
+    game_p->deck_counts = NULL;
+    switch (*pos++)
+    {
+        case LOG_DECK_INFINITE:
+            break;
+
+        case LOG_DECK_STANDARD:
+            game_p->deck_counts = STANDARD_DECK_COUNTS;
+            break;
+
+        case LOG_DECK_CUSTOM:
+            if (end - pos < FIRST_COLOR_CODE + 1)
+                return false;
+            game_p->deck_counts = pos; // The counts of the COLOR cards with a color aren't logged, the deck ignores them.
+            pos += FIRST_COLOR_CODE + 1;
+            break;
+
+        default:
+            return false;
+    }
+
+    // The deal.
+    if (pos >= end)
+        return false;
+    game_p->top_card = *pos++;
+    game_p->deal = pos;
+    for (int player_i = 0; player_i < game_p->nof_players; player_i++)
+    {
+        if (!Decode_Varint(&pos, end, &value) || value > (uint64_t) (end - pos))
+            return false;
+        pos += value;
+    }
+
+    // The moves, until the end of the game.
+    game_p->moves = pos;
+    while (pos < end && *pos != LOG_GAME_END)
+        pos++;
+    game_p->nof_moves = (int) (pos - game_p->moves);
+
+    if (pos >= end)
+        return false;
+    pos++;
+
+    if (!Decode_Varint(&pos, end, &value))
+        return false;
+    game_p->winner_index = (int) value;
+
+    reader_p->pos = end; // The next record is after this one. A broken record stops the reading at its start.
+    return true;
+}
+
+
+/*
+ * Replay a logged game through the engine, and check that it gives the same deal and the same winner.
+ * Receives a pointer to the logged game and a pointer to the game's data, which needs to be freed with Engine_Free_Game.
+ * Returns true if the game was replayed exactly, false otherwise.
+ */
+bool Log_Replay_Game(const LOGGED_GAME* logged_p, GAME_DATA* game_data_p)
+{
+    const unsigned char* deal = logged_p->deal; // The position in the logged deal.
+    CARD cards[MAX_DECK_SIZE]; // The cards of a player's start hand.
+
+    Engine_Init_Game(game_data_p, logged_p->nof_players, logged_p->seed, logged_p->stream, logged_p->deck_counts, NULL);
+
+    // Check the deal.
+    if (game_data_p->top_card != logged_p->top_card)
+        return false;
+    for (int player_i = 0; player_i < logged_p->nof_players; player_i++)
+    {
+        uint64_t nof_cards; // The number of cards the player got in the log.
+        int nof_dealt = Hand_Get_Cards(&game_data_p->players[player_i].hand, cards); // The number of cards the player got.
+
+        // The deal ends where the moves start.
+        if (!Decode_Varint(&deal, logged_p->moves, &nof_cards) || nof_cards != (uint64_t) nof_dealt || memcmp(deal, cards, nof_dealt) != 0)
+            return false;
+        deal += nof_cards;
+    }
+
+    // Apply every move, every one of them needs to be legal.
+    for (int move_i = 0; move_i < logged_p->nof_moves; move_i++)
+        if (!Engine_Apply_Move(game_data_p, Log_Decode_Move(logged_p->moves[move_i])))
+            return false;
+
+    return game_data_p->is_game_won && game_data_p->winner_index == logged_p->winner_index;
+}
@@ -0,0 +1,355 @@
+#include "header.h"
+
+// ---------------------- Policy Functions -----------------------
+// A seat of the simulation can be played by a policy plugin: a shared object built against taki_policy.h only.
+// The plugin never sees the game's structures. Every call gets a small view of the game, built on the stack for the call,
+// and the hand is passed as a pointer to the player's counts, so nothing big is copied on a move.
+// A policy is swapped while the simulation runs (SIGHUP): new games take the new policy, the games already playing keep the old one,
+// and the old shared object is closed when its last game ends.
+
+static atomic_bool is_reload_requested = false; // Set by the SIGHUP handler, taken by the next game that starts.
+
+
+/*
+ * Load a policy plugin.
+ * The shared object is copied to a temporary file and loaded from there, so a newer build of the same path is loaded as a new object
+ * (the dynamic loader returns the object already loaded for a path), and the plugin's file can be replaced while it is loaded.
+ * Receives the path of the shared object.
+ * Returns a pointer to the loaded policy, or NULL if it can't be loaded (an error message is printed).
+ * If the allocation failed, prints error message and ends the program.
+ */
+LOADED_POLICY* Policy_Load(const char* path)
+{
+    char temp_path[] = "/tmp/taki_policy_XXXXXX"; // The path of the copy that is loaded.
+    char buffer[1 << 14]; // The buffer for copying the shared object.
+    ssize_t nof_read; // The number of bytes read into the buffer.
+    int src_fd, dst_fd; // The shared object and its copy.
+    bool is_copied = true; // If all the shared object was copied.
+    void* handle; // The handle of the loaded copy.
+    TAKI_GET_POLICY_FUNC get_policy; // The function the plugin exports.
+    const TAKI_POLICY* policy_p; // The plugin's table.
+    LOADED_POLICY* loaded_p; // The result.
+
+    // Copy the shared object.
+    src_fd = open(path, O_RDONLY);
+    if (src_fd < 0)
+    {
+        printf("Can't open the policy %s!!!\n", path);
+        return NULL;
+    }
+    dst_fd = mkstemp(temp_path);
+    if (dst_fd < 0)
+    {
+        printf("Can't create a copy of the policy %s!!!\n", path);
+        close(src_fd);
+        return NULL;
+    }
+    while ((nof_read = read(src_fd, buffer, sizeof(buffer))) > 0)
+        if (write(dst_fd, buffer, nof_read) != nof_read)
+        {
+            is_copied = false;
+            break;
+        }
+    if (nof_read < 0)
+        is_copied = false;
+    close(src_fd);
+    close(dst_fd);
+
+    // Load the copy. The loaded object stays mapped after its file is removed.
+    handle = is_copied ? dlopen(temp_path, RTLD_NOW | RTLD_LOCAL) : NULL;
+    unlink(temp_path);
+    if (handle == NULL)
+    {
+        printf("Can't load the policy %s: %s!!!\n", path, is_copied ? dlerror() : "copy failed");
+        return NULL;
+    }
+
+    // Get the plugin's table, and check that it was built for this game.
+    *(void**) &get_policy = dlsym(handle, TAKI_POLICY_ENTRY);
+    policy_p = (get_policy != NULL) ? get_policy() : NULL;
+    if (policy_p == NULL || policy_p->abi_version != TAKI_POLICY_ABI_VERSION || policy_p->choose_card == NULL)
+    {
+        if (policy_p == NULL)
+            printf("The policy %s doesn't export %s!!!\n", path, TAKI_POLICY_ENTRY);
+        else if (policy_p->abi_version != TAKI_POLICY_ABI_VERSION)
+            printf("The policy %s was built for ABI version %u, the game's version is %d!!!\n", path, policy_p->abi_version, TAKI_POLICY_ABI_VERSION);
+        else
+            printf("The policy %s has no choose_card function!!!\n", path);
+        dlclose(handle);
+        return NULL;
+    }
+
+    // Try to allocate the loaded policy.
+    loaded_p = (LOADED_POLICY*) malloc(sizeof(LOADED_POLICY));
+    if (loaded_p == NULL)
+    {
+        printf("Memory allocation failed!!!\n");
+        exit(1);
+    }
+    loaded_p->handle = handle;
+    loaded_p->policy_p = policy_p;
+    loaded_p->nof_users = 0;
+
+    return loaded_p;
+}
+
+
+/*
+ * Close the shared object of a loaded policy, and free it.
+ * Receives a pointer to the loaded policy. No game may use it.
+ */
+void Policy_Unload(LOADED_POLICY* loaded_p)
+{
+    dlclose(loaded_p->handle);
+    free(loaded_p);
+}
+
+
+/*
+ * Initialize the slot of a seat, and load its policy.
+ * Receives a pointer to the slot and the path of the policy, NULL for the automatic player.
+ * If the policy can't be loaded, prints error message and ends the program.
+ */
+void Policy_Slot_Init(POLICY_SLOT* slot_p, const char* path)
+{
+    slot_p->path = path;
+    slot_p->current_p = NULL;
+    pthread_mutex_init(&slot_p->mutex, NULL);
+
+    if (path != NULL)
+    {
+        slot_p->current_p = Policy_Load(path);
+        if (slot_p->current_p == NULL)
+            exit(1);
+    }
+}
+
+
+/*
+ * Unload the policy of a slot. All the games must have ended.
+ * Receives a pointer to the slot.
+ */
+void Policy_Slot_Free(POLICY_SLOT* slot_p)
+{
+    if (slot_p->current_p != NULL)
+        Policy_Unload(slot_p->current_p);
+    slot_p->current_p = NULL;
+    pthread_mutex_destroy(&slot_p->mutex);
+}
+
+
+/*
+ * Load the policy of a slot again from its path, and make it the policy of new games.
+ * The old policy is unloaded now if no game uses it, or else by the last game that uses it.
+ * Receives a pointer to the slot.
+ * Returns true if the new policy was loaded, false if the slot has no policy or the load failed (the old policy stays).
+ */
+bool Policy_Slot_Reload(POLICY_SLOT* slot_p)
+{
+    LOADED_POLICY* new_p; // The newly loaded policy.
+    LOADED_POLICY* old_p; // The policy it replaces.
+
+    if (slot_p->path == NULL)
+        return false;
+
+    // Load outside of the lock, the games keep starting with the old policy meanwhile.
+    new_p = Policy_Load(slot_p->path);
+    if (new_p == NULL)
+        return false;
+
+    pthread_mutex_lock(&slot_p->mutex);
+    old_p = slot_p->current_p;
+    slot_p->current_p = new_p;
+    if (old_p->nof_users > 0)
+        old_p = NULL; // The last game that uses it unloads it.
+    pthread_mutex_unlock(&slot_p->mutex);
+
+    if (old_p != NULL)
+        Policy_Unload(old_p);
+
+    return true;
+}
+
+
+/*
+ * Take the current policy of a slot for a game.
+ * Receives a pointer to the slot.
+ * Returns the policy, NULL for the automatic player. It must be returned with Policy_Slot_Release.
+ */
+LOADED_POLICY* Policy_Slot_Acquire(POLICY_SLOT* slot_p)
+{
+    LOADED_POLICY* loaded_p; // The result.
+
+    if (slot_p->path == NULL)
+        return NULL;
+
+    pthread_mutex_lock(&slot_p->mutex);
+    loaded_p = slot_p->current_p;
+    loaded_p->nof_users++;
+    pthread_mutex_unlock(&slot_p->mutex);
+
+    return loaded_p;
+}
+
+
+/*
+ * Return a policy taken with Policy_Slot_Acquire. If it was replaced and this was its last game, it is unloaded.
+ * Receives a pointer to the slot and the policy.
+ */
+void Policy_Slot_Release(POLICY_SLOT* slot_p, LOADED_POLICY* loaded_p)
+{
+    bool is_unused; // If the policy was replaced and no game uses it anymore.
+
+    if (loaded_p == NULL)
+        return;
+
+    pthread_mutex_lock(&slot_p->mutex);
+    is_unused = (--loaded_p->nof_users == 0 && loaded_p != slot_p->current_p);
+    pthread_mutex_unlock(&slot_p->mutex);
+
+    if (is_unused)
+        Policy_Unload(loaded_p);
+}
+
+
+/*
+ * Take the policies of all the seats for a game, and create their states.
+ * Receives a pointer to the seats' policies, the slots of the seats, the number of players and the game's seed for the states.
+ */
+void Seat_Policies_Begin(SEAT_POLICIES* seats_p, POLICY_SLOT slots[], int nof_players, uint64_t seed)
+{
+    seats_p->nof_players = nof_players;
+    seats_p->slots = slots;
+
+    for (int seat_i = 0; seat_i < nof_players; seat_i++)
+    {
+        const TAKI_POLICY* policy_p; // The policy of the seat.
+
+        seats_p->policies[seat_i] = Policy_Slot_Acquire(&slots[seat_i]);
+        seats_p->states[seat_i] = NULL;
+
+        // Every seat gets its own state, with its own seed.
+        policy_p = (seats_p->policies[seat_i] != NULL) ? seats_p->policies[seat_i]->policy_p : NULL;
+        if (policy_p != NULL && policy_p->create != NULL)
+            seats_p->states[seat_i] = policy_p->create(seed ^ ((uint64_t) (seat_i + 1) * 0x9E3779B97F4A7C15ULL));
+    }
+}
+
+
+/*
+ * Destroy the states of the seats' policies, and return the policies to their slots.
+ * Receives a pointer to the seats' policies.
+ */
+void Seat_Policies_End(SEAT_POLICIES* seats_p)
+{
+    for (int seat_i = 0; seat_i < seats_p->nof_players; seat_i++)
+    {
+        LOADED_POLICY* loaded_p = seats_p->policies[seat_i]; // The policy of the seat.
+
+        if (loaded_p != NULL && loaded_p->policy_p->destroy != NULL)
+            loaded_p->policy_p->destroy(seats_p->states[seat_i]);
+        Policy_Slot_Release(&seats_p->slots[seat_i], loaded_p);
+    }
+}
+
+
+/*
+ * Choose the move of the current player with the policy of its seat. Matches CHOOSE_MOVE_FUNC.
+ * A seat without a policy is played by the automatic player (Choose_Auto_Move).
+ * Receives a pointer to the game's data and a pointer to the seats' policies (SEAT_POLICIES).
+ */
+MOVE Choose_Seat_Move(const GAME_DATA* game_data_p, void* context_p)
+{
+    SEAT_POLICIES* seats_p = (SEAT_POLICIES*) context_p; // The policies of the game's seats.
+    LOADED_POLICY* loaded_p = seats_p->policies[game_data_p->player_index]; // The policy of the current player.
+
+    if (loaded_p == NULL)
+        return Choose_Auto_Move(game_data_p, NULL);
+
+    return Choose_Policy_Move(game_data_p, loaded_p->policy_p, seats_p->states[game_data_p->player_index]);
+}
+
+
+/*
+ * Ask a policy for the move of the current player. The functions the policy doesn't have use their defaults (taki_policy.h).
+ * A card that can't be dropped is turned into the always legal move by the engine.
+ * Receives a pointer to the game's data, a pointer to the policy and the policy's state for the current player.
+ */
+MOVE Choose_Policy_Move(const GAME_DATA* game_data_p, const TAKI_POLICY* policy_p, void* state)
+{
+    TAKI_POLICY_VIEW view; // What the player can see, built for this move.
+    MOVE move = Engine_Default_Move(game_data_p); // The result move, draw a card or close the TAKI sequence unless a card is chosen.
+    int card; // The card code the policy chose.
+
+    Policy_Fill_View(game_data_p, &view);
+
+    // In a TAKI sequence, ask first if the player wants to continue it. Outside of it, ask if the player wants to draw.
+    if (game_data_p->is_taki_open ? (policy_p->continue_taki != NULL && !policy_p->continue_taki(state, &view))
+                                  : (policy_p->choose_draw != NULL && policy_p->choose_draw(state, &view)))
+        return move;
+
+    card = policy_p->choose_card(state, &view);
+    if (card < 0 || card >= NOF_CARD_CODES)
+        return move;
+
+    move.kind = MOVE_PLAY;
+    move.card = (CARD) card;
+    move.color = Get_Card_Color(game_data_p->top_card);
+
+    // A COLOR card dropped outside of a TAKI sequence needs a color.
+    if (card == FIRST_COLOR_CODE && !game_data_p->is_taki_open && policy_p->choose_color != NULL)
+    {
+        int color = policy_p->choose_color(state, &view); // The color the policy chose.
+
+        if (Is_Valid_Color(color))
+            move.color = (CARD_COLOR) color;
+    }
+
+    return move;
+}
+
+
+/*
+ * Build the view of the game the current player can see.
+ * Receives a pointer to the game's data and a pointer to the view to fill.
+ */
+void Policy_Fill_View(const GAME_DATA* game_data_p, TAKI_POLICY_VIEW* view_p)
+{
+    const HAND* hand_p = &game_data_p->players[game_data_p->player_index].hand; // The current player's hand.
+
+    view_p->abi_version = TAKI_POLICY_ABI_VERSION;
+    view_p->nof_players = game_data_p->nof_players;
+    view_p->player_index = game_data_p->player_index;
+    view_p->top_card = game_data_p->top_card;
+    view_p->is_taki_open = game_data_p->is_taki_open;
+    view_p->is_direction_right = game_data_p->is_direction_right;
+    view_p->hand_counts = hand_p->counts;
+    view_p->nof_hand_cards = hand_p->nof_cards;
+    view_p->legal_plays = Get_Legal_Plays(game_data_p);
+    view_p->nof_draw_cards = game_data_p->deck.is_finite ? game_data_p->deck.nof_draw : -1;
+    view_p->nof_discard_cards = game_data_p->deck.nof_discard;
+
+    for (int player_i = 0; player_i < TAKI_MAX_PLAYERS; player_i++)
+        view_p->nof_cards[player_i] = (player_i < game_data_p->nof_players) ? game_data_p->players[player_i].hand.nof_cards : 0;
+}
+
+
+/*
+ * The handler of SIGHUP: ask the simulation to load the policies again. Only sets a flag, the next game that starts reloads them.
+ * Receives the number of the signal.
+ */
+void Policy_Request_Reload(int signal_num)
+{
+    (void) signal_num;
+    atomic_store(&is_reload_requested, true);
+}
+
+
+/*
+ * Take the request to reload the policies, so only one game reloads them.
+ * Returns true if a reload was requested since the last call.
+ */
+bool Policy_Take_Reload_Request(void)
+{
+    return atomic_load_explicit(&is_reload_requested, memory_order_relaxed) && atomic_exchange(&is_reload_requested, false);
+}
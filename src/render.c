@@ -0,0 +1,150 @@
+#include "header.h"
+
+// -------------------- Frame Functions ---------------------
+// A frame is the text of a whole screen of the game (the top card and the cards of the player), composed in memory.
+// The frame is written to the screen with a single write when it is complete, instead of a printf for every character.
+
+/*
+ * Initialize an empty frame.
+ * Receives a pointer to the frame.
+ */
+void Frame_Init(FRAME* frame_p)
+{
+    frame_p->len = 0;
+}
+
+
+/*
+ * Add characters to the end of the frame.
+ * If the frame's buffer is full, the frame is written to the screen first, so a frame of any size can be composed.
+ * Receives a pointer to the frame, the characters and their number.
+ */
+void Frame_Append(FRAME* frame_p, const char* chars, size_t nof_chars)
+{
+    // Write the frame when it can't fit the characters.
+    if (frame_p->len + nof_chars > FRAME_BUFFER_SIZE)
+    {
+        Frame_Flush(frame_p);
+
+        // Characters that can't fit an empty frame are written directly.
+        if (nof_chars > FRAME_BUFFER_SIZE)
+        {
+            Write_All(chars, nof_chars);
+            return;
+        }
+    }
+
+    memcpy(&frame_p->data[frame_p->len], chars, nof_chars);
+    frame_p->len += nof_chars;
+}
+
+
+/*
+ * Add formatted text to the end of the frame, in the same format as printf.
+ * Receives a pointer to the frame, the format string and its arguments.
+ */
+void Frame_Printf(FRAME* frame_p, const char* format, ...)
+{
+    char text[FRAME_LINE_SIZE]; // The formatted text.
+    va_list args; // The arguments of the format.
+    int len; // The length of the formatted text.
+
+    va_start(args, format);
+    len = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    // Check if the text was cut, then keep the part that fits.
+    if (len >= (int) sizeof(text))
+        len = sizeof(text) - 1;
+
+    if (len > 0)
+        Frame_Append(frame_p, text, (size_t) len);
+}
+
+
+/*
+ * Write the frame to the screen with a single write, and empty it.
+ * Text printed with printf before the frame is written first, so the screen keeps the order of the game.
+ * Receives a pointer to the frame.
+ */
+void Frame_Flush(FRAME* frame_p)
+{
+    fflush(stdout);
+    Write_All(frame_p->data, frame_p->len);
+    frame_p->len = 0;
+}
+
+
+/*
+ * Write characters to the screen, until all of them were written.
+ * Receives the characters and their number.
+ */
+void Write_All(const char* chars, size_t nof_chars)
+{
+    while (nof_chars > 0)
+    {
+        ssize_t nof_written = write(STDOUT_FILENO, chars, nof_chars); // The number of characters the write has written.
+
+        // Check if the write failed, the screen was closed.
+        if (nof_written < 0)
+        {
+            if (errno == EINTR)
+                continue; // Interrupted before writing anything, try again.
+            return;
+        }
+
+        chars += nof_written;
+        nof_chars -= (size_t) nof_written;
+    }
+}
+
+
+
+
+// -------------------- Glyph Functions ---------------------
+// There are only NOF_CARD_CODES different cards, so every card is drawn once into the glyph cache, and printing a card copies its rows.
+
+static CARD_GLYPH card_glyphs[NOF_CARD_CODES]; // The drawing of every card code.
+static pthread_once_t card_glyphs_once = PTHREAD_ONCE_INIT; // Draws the glyph cache once, on its first use.
+
+
+/*
+ * Draw the glyph of every card code into the glyph cache.
+ */
+void Init_Card_Glyphs(void)
+{
+    for (int card = 0; card < NOF_CARD_CODES; card++)
+        Draw_Card_Glyph(&card_glyphs[card], (CARD) card);
+}
+
+
+/*
+ * Get the drawing of a card from the glyph cache. The cache is drawn on the first call.
+ * Receives the card.
+ * Returns a pointer to the card's glyph.
+ */
+const CARD_GLYPH* Get_Card_Glyph(CARD card)
+{
+    pthread_once(&card_glyphs_once, Init_Card_Glyphs);
+
+    return &card_glyphs[card];
+}
+
+
+/*
+ * Get the width of the screen in characters.
+ * Asks the terminal, then the COLUMNS environment variable, and uses DEFAULT_SCREEN_WIDTH if both are unknown.
+ */
+int Get_Screen_Width(void)
+{
+    struct winsize window_size; // The size of the terminal.
+    const char* columns = getenv("COLUMNS"); // The width set by the shell, if any.
+
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &window_size) == 0 && window_size.ws_col > 0)
+        return window_size.ws_col;
+
+    if (columns != NULL && atoi(columns) > 0)
+        return atoi(columns);
+
+    return DEFAULT_SCREEN_WIDTH;
+}
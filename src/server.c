@@ -0,0 +1,1160 @@
+#define _GNU_SOURCE // For accept4.
+#include "header.h"
+
+// The server hosts many tables in one process. Every event loop runs on its own thread with its own epoll instance,
+// and owns the connections it accepted and the tables they opened, so a table and a connection are only touched by one thread.
+// A client at a table of another loop talks to it through messages posted to that loop's inbox.
+//
+// The protocol: lines of text, every line ends with '\n'. The ids are the server's numbers of the tables.
+// Client lines:
+//   NEW <players> [clients] [seed]   open a table, the client takes seat 0 and the seats after the clients are played by the server
+//   JOIN <id>                        take the next free seat of a table that waits for clients
+//   MOVE <id> <move code>            play a move, the codes are the bytes of the game log (Log_Encode_Move)
+//   QUIT <id>                        leave a table, the server plays the seat from now on
+//   PING                             answered with PONG
+// Server lines:
+//   SEAT <id> <seat> <players>       the client took a seat (0 based)
+//   START <id>                       every client joined, the game began
+//   TURN <id> <top card> <taki open 0/1> <legal move codes mask, hex> <hand card codes, comma separated>
+//   MOVE <id> <seat> <move code>     a seat played a move (every move of the table, sent to all of its clients)
+//   WIN <id> <seat>                  the game ended, the table is closed
+//   PONG
+//   ERR <id, 0 for none> <text>
+
+static SERVER* running_server_p = NULL; // The server that SIGINT and SIGTERM stop.
+
+// -------------------- Server Functions ---------------------
+
+/*
+ * Run the server until SIGINT or SIGTERM: listen on the address, and run the event loops.
+ * Receives the address (a TCP port, host:port, or the path of a Unix socket) and the number of event loops, 0 for one on every core.
+ * Returns true if the server ran, false if it couldn't listen on the address.
+ */
+bool Run_Server(const char* address, int nof_loops)
+{
+    SERVER server; // The server.
+    struct epoll_event event; // The registration of the listening socket and of the eventfds.
+    unsigned long long nof_games = 0, nof_moves = 0, nof_accepted = 0; // The totals of all the loops.
+
+    if (nof_loops <= 0)
+        nof_loops = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (nof_loops > SERVER_MAX_LOOPS)
+        nof_loops = SERVER_MAX_LOOPS;
+
+    server.listen_fd = Open_Listen_Socket(address);
+    if (server.listen_fd < 0)
+    {
+        printf("Can't listen on %s!!!\n", address);
+        return false;
+    }
+
+    server.nof_loops = nof_loops;
+    atomic_init(&server.is_stopping, false);
+    server.loops = (SERVER_LOOP*) calloc(nof_loops, sizeof(SERVER_LOOP));
+    if (server.loops == NULL)
+    {
+        printf("Memory allocation failed!!!\n");
+        exit(1);
+    }
+
+    // Create the event loops. They all wait on the listening socket, EPOLLEXCLUSIVE wakes only some of them for a new connection.
+    for (int loop_i = 0; loop_i < nof_loops; loop_i++)
+    {
+        SERVER_LOOP* loop_p = &server.loops[loop_i]; // The loop.
+
+        loop_p->loop_i = loop_i;
+        loop_p->server_p = &server;
+        loop_p->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        loop_p->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        Slot_Pool_Init(&loop_p->conns, sizeof(SERVER_CONN));
+        Slot_Pool_Init(&loop_p->tables, sizeof(SERVER_TABLE));
+        Rng_Seed(&loop_p->rng, (uint64_t) time(NULL), (uint64_t) loop_i);
+        pthread_mutex_init(&loop_p->inbox_mutex, NULL);
+
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.u64 = SERVER_LISTEN_ID;
+        if (loop_p->epoll_fd < 0 || loop_p->wake_fd < 0 || epoll_ctl(loop_p->epoll_fd, EPOLL_CTL_ADD, server.listen_fd, &event) < 0)
+        {
+            printf("Creating the event loops failed!!!\n");
+            exit(1);
+        }
+        event.events = EPOLLIN;
+        event.data.u64 = SERVER_WAKE_ID;
+        if (epoll_ctl(loop_p->epoll_fd, EPOLL_CTL_ADD, loop_p->wake_fd, &event) < 0)
+        {
+            printf("Creating the event loops failed!!!\n");
+            exit(1);
+        }
+    }
+
+    running_server_p = &server;
+    signal(SIGINT, Server_Stop_Signal);
+    signal(SIGTERM, Server_Stop_Signal);
+    printf("Serving on %s with %d event loops\n", address, nof_loops);
+    fflush(stdout);
+
+    // Loop 0 runs on this thread.
+    for (int loop_i = 1; loop_i < nof_loops; loop_i++)
+        if (pthread_create(&server.loops[loop_i].thread, NULL, Server_Loop_Thread, &server.loops[loop_i]) != 0)
+        {
+            printf("Creating the thread of an event loop failed!!!\n");
+            exit(1);
+        }
+    Server_Loop_Run(&server.loops[0]);
+    for (int loop_i = 1; loop_i < nof_loops; loop_i++)
+        pthread_join(server.loops[loop_i].thread, NULL);
+
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    running_server_p = NULL;
+
+    // Free the loops, with the messages that were never handled and the connections and tables that are still open.
+    for (int loop_i = 0; loop_i < nof_loops; loop_i++)
+    {
+        SERVER_LOOP* loop_p = &server.loops[loop_i]; // The loop.
+
+        while (loop_p->inbox_head != NULL)
+        {
+            SERVER_MESSAGE* next_p = loop_p->inbox_head->next; // The message after the freed one.
+
+            free(loop_p->inbox_head);
+            loop_p->inbox_head = next_p;
+        }
+        Slot_Pool_Free(&loop_p->conns, Conn_Free);
+        Slot_Pool_Free(&loop_p->tables, Table_Free);
+        free(loop_p->dirty_ids);
+        close(loop_p->wake_fd);
+        close(loop_p->epoll_fd);
+        pthread_mutex_destroy(&loop_p->inbox_mutex);
+
+        nof_games += loop_p->nof_games;
+        nof_moves += loop_p->nof_moves;
+        nof_accepted += loop_p->nof_accepted;
+    }
+    free(server.loops);
+    close(server.listen_fd);
+    if (strchr(address, '/') != NULL)
+        unlink(address);
+
+    printf("\nServed %llu connections, %llu games, %llu moves.\n", nof_accepted, nof_games, nof_moves);
+
+    return true;
+}
+
+
+/*
+ * The thread of an event loop.
+ * Receives a pointer to the loop.
+ * Returns NULL.
+ */
+void* Server_Loop_Thread(void* loop_vp)
+{
+    Server_Loop_Run((SERVER_LOOP*) loop_vp);
+
+    return NULL;
+}
+
+
+/*
+ * Run an event loop until the server stops: accept connections, read the clients' lines, handle the messages of the other loops,
+ * and at the end of every round of events write the output of every connection that got some, with a single send.
+ * Receives a pointer to the loop.
+ */
+void Server_Loop_Run(SERVER_LOOP* loop_p)
+{
+    struct epoll_event events[SERVER_MAX_EVENTS]; // The events of one wait.
+    int nof_events; // The number of events.
+
+    while (!atomic_load(&loop_p->server_p->is_stopping))
+    {
+        nof_events = epoll_wait(loop_p->epoll_fd, events, SERVER_MAX_EVENTS, -1);
+        if (nof_events < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            printf("Waiting for events failed!!!\n");
+            break;
+        }
+
+        for (int event_i = 0; event_i < nof_events; event_i++)
+        {
+            uint64_t id = events[event_i].data.u64; // The connection, or the listening socket or the eventfd.
+            SERVER_CONN* conn_p; // The connection of the event.
+
+            if (id == SERVER_LISTEN_ID)
+                Conn_Accept(loop_p);
+            else if (id == SERVER_WAKE_ID)
+            {
+                uint64_t count; // The eventfd's counter, read to reset it.
+
+                if (read(loop_p->wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN)
+                    printf("Reading the eventfd failed!!!\n");
+                Server_Drain_Inbox(loop_p);
+            }
+            else
+            {
+                // The connection may have been closed by an earlier event of this round.
+                conn_p = (SERVER_CONN*) Slot_Pool_Get(&loop_p->conns, id);
+                if (conn_p == NULL)
+                    continue;
+                if ((events[event_i].events & EPOLLOUT) && !Conn_Flush(conn_p))
+                    Conn_Close(loop_p, conn_p);
+                else if (events[event_i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                    Conn_Read(loop_p, conn_p);
+            }
+        }
+
+        // Write the output of the round. Closing a connection can give output to others, they are added to the end of the list.
+        for (int dirty_i = 0; dirty_i < loop_p->nof_dirty; dirty_i++)
+        {
+            SERVER_CONN* conn_p = (SERVER_CONN*) Slot_Pool_Get(&loop_p->conns, loop_p->dirty_ids[dirty_i]); // The connection to flush.
+
+            if (conn_p == NULL)
+                continue;
+            conn_p->is_dirty = false;
+            if (!Conn_Flush(conn_p) || conn_p->out_len - conn_p->out_pos > SERVER_MAX_OUT_SIZE)
+                Conn_Close(loop_p, conn_p);
+        }
+        loop_p->nof_dirty = 0;
+    }
+}
+
+
+/*
+ * The handler of SIGINT and SIGTERM: stops the server, and wakes all of its loops.
+ * Receives the number of the signal (unused).
+ */
+void Server_Stop_Signal(int signal_num)
+{
+    uint64_t one = 1; // Added to the eventfds' counters.
+
+    (void) signal_num;
+
+    if (running_server_p == NULL)
+        return;
+
+    atomic_store(&running_server_p->is_stopping, true);
+    for (int loop_i = 0; loop_i < running_server_p->nof_loops; loop_i++)
+        if (write(running_server_p->loops[loop_i].wake_fd, &one, sizeof(one)) < 0)
+            continue;
+}
+
+
+/*
+ * Open a non blocking socket that listens on an address. An old Unix socket file of the same path is removed first.
+ * Receives the address.
+ * Returns the socket, or -1 if it failed.
+ */
+int Open_Listen_Socket(const char* address)
+{
+    struct sockaddr_storage addr; // The address.
+    socklen_t addr_len; // The length of the address.
+    int fd, one = 1; // The socket, and the value of the options that are turned on.
+
+    if (!Parse_Socket_Address(address, &addr, &addr_len))
+        return -1;
+
+    fd = socket(addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+
+    if (addr.ss_family == AF_UNIX)
+        unlink(((struct sockaddr_un*) &addr)->sun_path);
+    else
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    if (bind(fd, (struct sockaddr*) &addr, addr_len) < 0 || listen(fd, SERVER_LISTEN_BACKLOG) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+
+/*
+ * Connect to a server. The socket is non blocking once it is connected.
+ * Receives the address of the server.
+ * Returns the socket, or -1 if it failed.
+ */
+int Connect_Socket(const char* address)
+{
+    struct sockaddr_storage addr; // The address.
+    socklen_t addr_len; // The length of the address.
+    int fd, one = 1; // The socket, and the value of the options that are turned on.
+
+    if (!Parse_Socket_Address(address, &addr, &addr_len))
+        return -1;
+
+    fd = socket(addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+
+    if (connect(fd, (struct sockaddr*) &addr, addr_len) < 0 || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    if (addr.ss_family != AF_UNIX)
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    return fd;
+}
+
+
+/*
+ * Parse an address: a path with a '/' is a Unix socket, "host:port" is an IPv4 address, and a port alone is on the loopback address.
+ * Receives the address, and pointers to the socket address and its length to fill.
+ * Returns true if the address is valid, false otherwise.
+ */
+bool Parse_Socket_Address(const char* address, struct sockaddr_storage* addr_p, socklen_t* addr_len_p)
+{
+    char host[INET_ADDRSTRLEN] = "127.0.0.1"; // The host of a TCP address.
+    const char* port_str = address; // The port of a TCP address.
+    const char* colon_p = strrchr(address, ':'); // The end of the host.
+    char* end_p; // The end of the port's number.
+    long port; // The port.
+    struct sockaddr_un* unix_addr_p = (struct sockaddr_un*) addr_p; // The address as a Unix socket address.
+    struct sockaddr_in* inet_addr_p = (struct sockaddr_in*) addr_p; // The address as an IPv4 address.
+
+    memset(addr_p, 0, sizeof(*addr_p));
+
+    if (strchr(address, '/') != NULL)
+    {
+        if (strlen(address) >= sizeof(unix_addr_p->sun_path))
+            return false;
+        unix_addr_p->sun_family = AF_UNIX;
+        strcpy(unix_addr_p->sun_path, address);
+        *addr_len_p = sizeof(struct sockaddr_un);
+        return true;
+    }
+
+    if (colon_p != NULL)
+    {
+        if (colon_p - address >= INET_ADDRSTRLEN)
+            return false;
+        memcpy(host, address, colon_p - address);
+        host[colon_p - address] = '\0';
+        port_str = colon_p + 1;
+    }
+
+    port = strtol(port_str, &end_p, 10);
+    if (*port_str == '\0' || *end_p != '\0' || port <= 0 || port > 65535)
+        return false;
+
+    inet_addr_p->sin_family = AF_INET;
+    inet_addr_p->sin_port = htons((uint16_t) port);
+    if (inet_pton(AF_INET, host, &inet_addr_p->sin_addr) != 1)
+        return false;
+    *addr_len_p = sizeof(struct sockaddr_in);
+
+    return true;
+}
+
+// -------------------- Slot Pool Functions ---------------------
+
+/*
+ * Initialize an empty pool of slots.
+ * Receives a pointer to the pool and the size of its objects.
+ */
+void Slot_Pool_Init(SLOT_POOL* pool_p, size_t item_size)
+{
+    memset(pool_p, 0, sizeof(*pool_p));
+    pool_p->item_size = item_size;
+}
+
+
+/*
+ * Take a slot for a new object: a released slot if there is one, its object's memory is reused, or else a new slot.
+ * Receives a pointer to the pool, the index of its loop, and pointers to the new object's id and to whether its memory is new.
+ * Returns the object, or NULL if the pool has no more slots.
+ */
+void* Slot_Pool_Acquire(SLOT_POOL* pool_p, int loop_i, uint64_t* id_p, bool* is_new_p)
+{
+    int slot; // The slot of the object.
+
+    *is_new_p = false;
+    if (pool_p->nof_free > 0)
+        slot = pool_p->free_slots[--pool_p->nof_free];
+    else
+    {
+        if (pool_p->nof_slots == 1 << 24)
+            return NULL;
+
+        // Grow the arrays.
+        if (pool_p->nof_slots == pool_p->phys_size)
+        {
+            int new_size = pool_p->phys_size == 0 ? 64 : pool_p->phys_size * 2; // The new physical size.
+            void** new_items; // The grown objects array.
+            uint32_t* new_generations; // The grown generations array.
+            int* new_free_slots; // The grown free slots stack.
+
+            new_items = (void**) realloc(pool_p->items, new_size * sizeof(void*));
+            if (new_items != NULL)
+                pool_p->items = new_items;
+            new_generations = (uint32_t*) realloc(pool_p->generations, new_size * sizeof(uint32_t));
+            if (new_generations != NULL)
+                pool_p->generations = new_generations;
+            new_free_slots = (int*) realloc(pool_p->free_slots, new_size * sizeof(int));
+            if (new_free_slots != NULL)
+                pool_p->free_slots = new_free_slots;
+
+            if (new_items == NULL || new_generations == NULL || new_free_slots == NULL)
+            {
+                printf("Memory allocation failed!!!\n");
+                exit(1);
+            }
+            pool_p->phys_size = new_size;
+        }
+
+        slot = pool_p->nof_slots++;
+        pool_p->items[slot] = malloc(pool_p->item_size);
+        if (pool_p->items[slot] == NULL)
+        {
+            printf("Memory allocation failed!!!\n");
+            exit(1);
+        }
+        pool_p->generations[slot] = 0;
+        *is_new_p = true;
+    }
+
+    pool_p->generations[slot]++; // Odd: the slot is used.
+    *id_p = ((uint64_t) pool_p->generations[slot] << 32) | ((uint64_t) slot << 8) | (uint64_t) loop_i;
+
+    return pool_p->items[slot];
+}
+
+
+/*
+ * Find the object of an id.
+ * Receives a pointer to the pool and the id.
+ * Returns the object, or NULL if the id's object was released (or the id was never given).
+ */
+void* Slot_Pool_Get(const SLOT_POOL* pool_p, uint64_t id)
+{
+    int slot = (int) ((id >> 8) & 0xFFFFFF); // The slot of the id.
+    uint32_t generation = (uint32_t) (id >> 32); // The generation of the id.
+
+    if (slot >= pool_p->nof_slots || pool_p->generations[slot] != generation || (generation & 1) == 0)
+        return NULL;
+
+    return pool_p->items[slot];
+}
+
+
+/*
+ * Release the slot of an object, its id isn't found anymore. The object's memory is kept for the next object of the slot.
+ * Receives a pointer to the pool and the id of the object.
+ */
+void Slot_Pool_Release(SLOT_POOL* pool_p, uint64_t id)
+{
+    int slot = (int) ((id >> 8) & 0xFFFFFF); // The slot of the id.
+
+    pool_p->generations[slot]++; // Even: the slot is free.
+    pool_p->free_slots[pool_p->nof_free++] = slot;
+}
+
+
+/*
+ * Free a pool and all of its objects.
+ * Receives a pointer to the pool, and a function that frees what an object holds (called for every object, used or released), or NULL.
+ */
+void Slot_Pool_Free(SLOT_POOL* pool_p, void (*free_item)(void* item))
+{
+    for (int slot = 0; slot < pool_p->nof_slots; slot++)
+    {
+        if (free_item != NULL)
+            free_item(pool_p->items[slot]);
+        free(pool_p->items[slot]);
+    }
+    free(pool_p->items);
+    free(pool_p->generations);
+    free(pool_p->free_slots);
+    memset(pool_p, 0, sizeof(*pool_p));
+}
+
+// -------------------- Message Functions ---------------------
+
+/*
+ * Post a message to the inbox of another loop, and wake the loop if its inbox was empty.
+ * Receives a pointer to the posting loop, the index of the target loop, and the message (allocated with malloc, the target frees it).
+ */
+void Server_Post(SERVER_LOOP* loop_p, int target_loop_i, SERVER_MESSAGE* message_p)
+{
+    SERVER_LOOP* target_p = &loop_p->server_p->loops[target_loop_i]; // The target loop.
+    uint64_t one = 1; // Added to the eventfd's counter.
+    bool was_empty; // True if the inbox was empty, the loop hasn't been woken for it yet.
+
+    message_p->next = NULL;
+
+    pthread_mutex_lock(&target_p->inbox_mutex);
+    was_empty = target_p->inbox_head == NULL;
+    if (was_empty)
+        target_p->inbox_head = message_p;
+    else
+        target_p->inbox_tail->next = message_p;
+    target_p->inbox_tail = message_p;
+    pthread_mutex_unlock(&target_p->inbox_mutex);
+
+    if (was_empty && write(target_p->wake_fd, &one, sizeof(one)) < 0)
+        printf("Waking an event loop failed!!!\n");
+}
+
+
+/*
+ * Handle all the messages posted to a loop, in the order they were posted.
+ * Receives a pointer to the loop.
+ */
+void Server_Drain_Inbox(SERVER_LOOP* loop_p)
+{
+    SERVER_MESSAGE* message_p; // The message handled.
+
+    pthread_mutex_lock(&loop_p->inbox_mutex);
+    message_p = loop_p->inbox_head;
+    loop_p->inbox_head = NULL;
+    loop_p->inbox_tail = NULL;
+    pthread_mutex_unlock(&loop_p->inbox_mutex);
+
+    while (message_p != NULL)
+    {
+        SERVER_MESSAGE* next_p = message_p->next; // The next message.
+
+        if (message_p->kind == SERVER_MSG_SEND)
+            Server_Send(loop_p, message_p->conn_id, message_p->line, message_p->len, message_p->table_id);
+        else
+            Server_To_Table(loop_p, message_p->kind, message_p->table_id, message_p->conn_id, message_p->value);
+
+        free(message_p);
+        message_p = next_p;
+    }
+}
+
+
+/*
+ * Send a line to a connection of any loop. A connection that was closed is skipped.
+ * Receives a pointer to the sending loop, the connection's id, the line and its length (0 to send nothing),
+ * and a table to remove from the connection's tables, or 0.
+ */
+void Server_Send(SERVER_LOOP* loop_p, uint64_t conn_id, const char* line, int len, uint64_t done_table_id)
+{
+    int conn_loop_i = (int) (conn_id & 0xFF); // The loop of the connection.
+    SERVER_MESSAGE* message_p; // The message to the connection's loop.
+    SERVER_CONN* conn_p; // The connection.
+
+    if (conn_loop_i == loop_p->loop_i)
+    {
+        conn_p = (SERVER_CONN*) Slot_Pool_Get(&loop_p->conns, conn_id);
+        if (conn_p == NULL)
+            return;
+        if (done_table_id != 0)
+            Conn_Remove_Table(conn_p, done_table_id);
+        if (len > 0)
+            Conn_Write(loop_p, conn_p, line, len);
+        return;
+    }
+
+    message_p = (SERVER_MESSAGE*) malloc(sizeof(SERVER_MESSAGE) + len);
+    if (message_p == NULL)
+    {
+        printf("Memory allocation failed!!!\n");
+        exit(1);
+    }
+    message_p->kind = SERVER_MSG_SEND;
+    message_p->conn_id = conn_id;
+    message_p->table_id = done_table_id;
+    message_p->value = 0;
+    message_p->len = len;
+    memcpy(message_p->line, line, len);
+    Server_Post(loop_p, conn_loop_i, message_p);
+}
+
+
+/*
+ * Pass a client's request to its table: handled now if the table is of this loop, or else posted to the table's loop.
+ * Receives a pointer to the loop, the kind of the request (join, move or leave), the table's id, the connection's id and the move code.
+ */
+void Server_To_Table(SERVER_LOOP* loop_p, SERVER_MESSAGE_KIND kind, uint64_t table_id, uint64_t conn_id, int value)
+{
+    int table_loop_i = (int) (table_id & 0xFF); // The loop of the table.
+    SERVER_MESSAGE* message_p; // The message to the table's loop.
+
+    // An id of no loop isn't found at this loop either, and is answered with an error.
+    if (table_loop_i != loop_p->loop_i && table_loop_i < loop_p->server_p->nof_loops)
+    {
+        message_p = (SERVER_MESSAGE*) malloc(sizeof(SERVER_MESSAGE));
+        if (message_p == NULL)
+        {
+            printf("Memory allocation failed!!!\n");
+            exit(1);
+        }
+        message_p->kind = kind;
+        message_p->conn_id = conn_id;
+        message_p->table_id = table_id;
+        message_p->value = value;
+        message_p->len = 0;
+        Server_Post(loop_p, table_loop_i, message_p);
+        return;
+    }
+
+    switch (kind)
+    {
+        case SERVER_MSG_JOIN:
+            Table_Join(loop_p, table_id, conn_id);
+            break;
+        case SERVER_MSG_MOVE:
+            Table_Move(loop_p, table_id, conn_id, value);
+            break;
+        case SERVER_MSG_LEAVE:
+            Table_Leave(loop_p, table_id, conn_id);
+            break;
+        default:
+            break;
+    }
+}
+
+// -------------------- Connection Functions ---------------------
+
+/*
+ * Accept a waiting connection. Only one is accepted on every wake up, so the connections spread over all the loops.
+ * Receives a pointer to the loop.
+ */
+void Conn_Accept(SERVER_LOOP* loop_p)
+{
+    struct epoll_event event; // The registration of the connection.
+    SERVER_CONN* conn_p; // The new connection.
+    uint64_t conn_id; // Its id.
+    bool is_new; // Unused, a connection has nothing to keep between its uses of a slot.
+    int fd, one = 1; // The socket, and the value of TCP_NODELAY.
+
+    fd = accept4(loop_p->server_p->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0)
+        return; // Another loop took it.
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Fails harmlessly on a Unix socket.
+
+    conn_p = (SERVER_CONN*) Slot_Pool_Acquire(&loop_p->conns, loop_p->loop_i, &conn_id, &is_new);
+    if (conn_p == NULL)
+    {
+        close(fd);
+        return;
+    }
+    memset(conn_p, 0, sizeof(*conn_p));
+    conn_p->id = conn_id;
+    conn_p->fd = fd;
+
+    // Edge triggered: a read reads until the socket is empty, and EPOLLOUT comes only when a full socket has room again.
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.u64 = conn_id;
+    if (epoll_ctl(loop_p->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        close(fd);
+        conn_p->fd = -1;
+        Slot_Pool_Release(&loop_p->conns, conn_id);
+        return;
+    }
+
+    loop_p->nof_accepted++;
+}
+
+
+/*
+ * Read everything the client sent, and handle every whole line. The connection is closed if the client closed it or sent a too long line.
+ * Receives a pointer to the loop and the connection.
+ */
+void Conn_Read(SERVER_LOOP* loop_p, SERVER_CONN* conn_p)
+{
+    char buffer[SERVER_READ_SIZE]; // The bytes read.
+    ssize_t nof_read; // The number of bytes read.
+
+    while (true)
+    {
+        nof_read = recv(conn_p->fd, buffer, sizeof(buffer), 0);
+        if (nof_read < 0 && errno == EINTR)
+            continue;
+        if (nof_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+        if (nof_read <= 0)
+        {
+            Conn_Close(loop_p, conn_p);
+            return;
+        }
+
+        for (ssize_t byte_i = 0; byte_i < nof_read; byte_i++)
+        {
+            if (buffer[byte_i] != '\n')
+            {
+                if (conn_p->in_len == SERVER_MAX_LINE - 1)
+                {
+                    Conn_Close(loop_p, conn_p);
+                    return;
+                }
+                conn_p->in[conn_p->in_len++] = buffer[byte_i];
+                continue;
+            }
+
+            if (conn_p->in_len > 0 && conn_p->in[conn_p->in_len - 1] == '\r')
+                conn_p->in_len--;
+            conn_p->in[conn_p->in_len] = '\0';
+            conn_p->in_len = 0;
+            Conn_Handle_Line(loop_p, conn_p, conn_p->in);
+        }
+    }
+}
+
+
+/*
+ * Handle a line of a client: open, join or leave a table, or play a move.
+ * Receives a pointer to the loop, the connection, and the line (without its '\n').
+ */
+void Conn_Handle_Line(SERVER_LOOP* loop_p, SERVER_CONN* conn_p, char* line)
+{
+    char reply[SERVER_MAX_OUT_LINE]; // The answer to a line that isn't understood.
+    unsigned long long table_id, seed; // The table and the seed of the line.
+    int nof_players, nof_humans = 1, move_code; // The numbers of the line.
+    int nof_values; // The number of values read from the line.
+
+    if (line[0] == '\0')
+        return;
+
+    if (!strncmp(line, "MOVE ", 5) && sscanf(line + 5, "%llu %d", &table_id, &move_code) == 2)
+        Server_To_Table(loop_p, SERVER_MSG_MOVE, table_id, conn_p->id, move_code);
+    else if (!strncmp(line, "NEW ", 4) && (nof_values = sscanf(line + 4, "%d %d %llu", &nof_players, &nof_humans, &seed)) >= 1)
+    {
+        if (nof_values < 3)
+            seed = ((uint64_t) Rng_Next(&loop_p->rng) << 32) | Rng_Next(&loop_p->rng);
+        Table_Create(loop_p, conn_p, nof_players, nof_humans, seed);
+    }
+    else if (!strncmp(line, "JOIN ", 5) && sscanf(line + 5, "%llu", &table_id) == 1)
+    {
+        Conn_Add_Table(conn_p, table_id);
+        Server_To_Table(loop_p, SERVER_MSG_JOIN, table_id, conn_p->id, 0);
+    }
+    else if (!strncmp(line, "QUIT ", 5) && sscanf(line + 5, "%llu", &table_id) == 1)
+    {
+        Conn_Remove_Table(conn_p, table_id);
+        Server_To_Table(loop_p, SERVER_MSG_LEAVE, table_id, conn_p->id, 0);
+    }
+    else if (!strcmp(line, "PING"))
+        Conn_Write(loop_p, conn_p, "PONG\n", 5);
+    else
+        Conn_Write(loop_p, conn_p, reply, snprintf(reply, sizeof(reply), "ERR 0 unknown command\n"));
+}
+
+
+/*
+ * Add output to a connection, it is written at the end of the loop's round. The output of a client that stopped reading is dropped.
+ * Receives a pointer to the loop, the connection, the characters and their number.
+ */
+void Conn_Write(SERVER_LOOP* loop_p, SERVER_CONN* conn_p, const char* chars, int len)
+{
+    if (conn_p->out_len - conn_p->out_pos > SERVER_MAX_OUT_SIZE)
+        return; // The connection is closed at the flush.
+
+    // Move the output that is still waiting to the start, before growing the buffer for it.
+    if (conn_p->out_pos > 0 && conn_p->out_len + len > conn_p->out_phys_size)
+    {
+        memmove(conn_p->out, &conn_p->out[conn_p->out_pos], conn_p->out_len - conn_p->out_pos);
+        conn_p->out_len -= conn_p->out_pos;
+        conn_p->out_pos = 0;
+    }
+    if (conn_p->out_len + len > conn_p->out_phys_size)
+    {
+        size_t new_size = conn_p->out_phys_size == 0 ? SERVER_OUT_START_SIZE : conn_p->out_phys_size * 2; // The new physical size.
+
+        while (new_size < conn_p->out_len + len)
+            new_size *= 2;
+        char* new_out = (char*) realloc(conn_p->out, new_size); // The grown buffer.
+        if (new_out == NULL)
+        {
+            printf("Memory allocation failed!!!\n");
+            exit(1);
+        }
+        conn_p->out = new_out;
+        conn_p->out_phys_size = new_size;
+    }
+
+    memcpy(&conn_p->out[conn_p->out_len], chars, len);
+    conn_p->out_len += len;
+
+    // Add the connection to the connections to flush.
+    if (!conn_p->is_dirty)
+    {
+        if (loop_p->nof_dirty == loop_p->dirty_phys_size)
+        {
+            int new_size = loop_p->dirty_phys_size == 0 ? 64 : loop_p->dirty_phys_size * 2; // The new physical size.
+            uint64_t* new_ids = (uint64_t*) realloc(loop_p->dirty_ids, new_size * sizeof(uint64_t)); // The grown array.
+
+            if (new_ids == NULL)
+            {
+                printf("Memory allocation failed!!!\n");
+                exit(1);
+            }
+            loop_p->dirty_ids = new_ids;
+            loop_p->dirty_phys_size = new_size;
+        }
+        loop_p->dirty_ids[loop_p->nof_dirty++] = conn_p->id;
+        conn_p->is_dirty = true;
+    }
+}
+
+
+/*
+ * Write as much of a connection's output as the socket takes. The rest waits for EPOLLOUT.
+ * Receives a pointer to the connection.
+ * Returns false if the connection failed and needs to be closed, true otherwise.
+ */
+bool Conn_Flush(SERVER_CONN* conn_p)
+{
+    ssize_t nof_sent; // The number of bytes sent.
+
+    while (conn_p->out_pos < conn_p->out_len)
+    {
+        nof_sent = send(conn_p->fd, &conn_p->out[conn_p->out_pos], conn_p->out_len - conn_p->out_pos, MSG_NOSIGNAL);
+        if (nof_sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        conn_p->out_pos += nof_sent;
+    }
+    conn_p->out_pos = 0;
+    conn_p->out_len = 0;
+
+    return true;
+}
+
+
+/*
+ * Close a connection. The server plays its seats from now on.
+ * Receives a pointer to the loop and the connection.
+ */
+void Conn_Close(SERVER_LOOP* loop_p, SERVER_CONN* conn_p)
+{
+    uint64_t conn_id = conn_p->id; // The id of the connection, the tables find its seats by it.
+    uint64_t* table_ids = conn_p->table_ids; // The tables of the connection.
+    int nof_tables = conn_p->nof_tables; // Their number.
+
+    close(conn_p->fd); // Also removes it from the epoll instance.
+    free(conn_p->out);
+    conn_p->fd = -1;
+    conn_p->out = NULL;
+    conn_p->table_ids = NULL;
+    conn_p->nof_tables = 0;
+    Slot_Pool_Release(&loop_p->conns, conn_id);
+
+    // Leave the tables after the connection is released, so they don't send it anything.
+    for (int table_i = 0; table_i < nof_tables; table_i++)
+        Server_To_Table(loop_p, SERVER_MSG_LEAVE, table_ids[table_i], conn_id, 0);
+    free(table_ids);
+}
+
+
+/*
+ * Free what a connection holds, when its loop is freed.
+ * Receives a pointer to the connection.
+ */
+void Conn_Free(void* conn_vp)
+{
+    SERVER_CONN* conn_p = (SERVER_CONN*) conn_vp; // The connection.
+
+    if (conn_p->fd >= 0)
+        close(conn_p->fd);
+    free(conn_p->out);
+    free(conn_p->table_ids);
+}
+
+
+/*
+ * Add a table to the tables of a connection.
+ * Receives a pointer to the connection and the table's id.
+ */
+void Conn_Add_Table(SERVER_CONN* conn_p, uint64_t table_id)
+{
+    if (conn_p->nof_tables == conn_p->tables_phys_size)
+    {
+        int new_size = conn_p->tables_phys_size == 0 ? 4 : conn_p->tables_phys_size * 2; // The new physical size.
+        uint64_t* new_ids = (uint64_t*) realloc(conn_p->table_ids, new_size * sizeof(uint64_t)); // The grown array.
+
+        if (new_ids == NULL)
+        {
+            printf("Memory allocation failed!!!\n");
+            exit(1);
+        }
+        conn_p->table_ids = new_ids;
+        conn_p->tables_phys_size = new_size;
+    }
+
+    conn_p->table_ids[conn_p->nof_tables++] = table_id;
+}
+
+
+/*
+ * Remove a table from the tables of a connection (one seat of it, if the connection has several).
+ * Receives a pointer to the connection and the table's id.
+ */
+void Conn_Remove_Table(SERVER_CONN* conn_p, uint64_t table_id)
+{
+    for (int table_i = conn_p->nof_tables - 1; table_i >= 0; table_i--)
+        if (conn_p->table_ids[table_i] == table_id)
+        {
+            conn_p->table_ids[table_i] = conn_p->table_ids[--conn_p->nof_tables];
+            return;
+        }
+}
+
+// -------------------- Table Functions ---------------------
+
+/*
+ * Open a table at the client's loop. The client takes seat 0, and the game starts at once if no other client needs to join.
+ * Receives a pointer to the loop, the client's connection, the number of players, the number of seats of clients, and the game's seed.
+ */
+void Table_Create(SERVER_LOOP* loop_p, SERVER_CONN* conn_p, int nof_players, int nof_humans, uint64_t seed)
+{
+    char line[SERVER_MAX_OUT_LINE]; // The line to the client.
+    SERVER_TABLE* table_p; // The new table.
+    uint64_t table_id; // Its id.
+    bool is_new; // True if the table's memory is new, its arena isn't initialized yet.
+
+    if (nof_players < 2 || nof_players > MAX_SIM_PLAYERS || nof_humans < 1 || nof_humans > nof_players)
+    {
+        Conn_Write(loop_p, conn_p, line, snprintf(line, sizeof(line), "ERR 0 a table has 2-%d players and at least one client\n", MAX_SIM_PLAYERS));
+        return;
+    }
+
+    table_p = (SERVER_TABLE*) Slot_Pool_Acquire(&loop_p->tables, loop_p->loop_i, &table_id, &is_new);
+    if (table_p == NULL)
+    {
+        Conn_Write(loop_p, conn_p, line, snprintf(line, sizeof(line), "ERR 0 too many tables\n"));
+        return;
+    }
+    if (is_new)
+        Arena_Init(&table_p->arena, SERVER_ARENA_CHUNK_SIZE);
+
+    table_p->id = table_id;
+    table_p->nof_humans = nof_humans;
+    table_p->nof_joined = 1;
+    table_p->is_started = false;
+    memset(table_p->seat_conns, 0, sizeof(table_p->seat_conns));
+    table_p->seat_conns[0] = conn_p->id;
+    Engine_Init_Game(&table_p->game_data, nof_players, seed, table_id, STANDARD_DECK_COUNTS, &table_p->arena);
+
+    Conn_Add_Table(conn_p, table_id);
+    Conn_Write(loop_p, conn_p, line, snprintf(line, sizeof(line), "SEAT %llu 0 %d\n", (unsigned long long) table_id, nof_players));
+
+    if (table_p->nof_joined == table_p->nof_humans)
+        Table_Start(loop_p, table_p);
+}
+
+
+/*
+ * Seat a client at a table that waits for clients, and start the game when the last one joins.
+ * Receives a pointer to the table's loop, the table's id and the client's connection id.
+ */
+void Table_Join(SERVER_LOOP* loop_p, uint64_t table_id, uint64_t conn_id)
+{
+    char line[SERVER_MAX_OUT_LINE]; // The line to the client.
+    SERVER_TABLE* table_p = (SERVER_TABLE*) Slot_Pool_Get(&loop_p->tables, table_id); // The table.
+    int seat_i; // The client's seat.
+
+    if (table_p == NULL || table_p->is_started)
+    {
+        Server_Send(loop_p, conn_id, line, snprintf(line, sizeof(line), "ERR %llu the table can't be joined\n", (unsigned long long) table_id), table_id);
+        return;
+    }
+
+    seat_i = table_p->nof_joined++;
+    table_p->seat_conns[seat_i] = conn_id;
+    Server_Send(loop_p, conn_id, line,
+                snprintf(line, sizeof(line), "SEAT %llu %d %d\n", (unsigned long long) table_id, seat_i, table_p->game_data.nof_players), 0);
+
+    if (table_p->nof_joined == table_p->nof_humans)
+        Table_Start(loop_p, table_p);
+}
+
+
+/*
+ * Play the move of a client. A move out of turn or an illegal move is answered with an error, and the table keeps waiting.
+ * Receives a pointer to the table's loop, the table's id, the client's connection id and the move code.
+ */
+void Table_Move(SERVER_LOOP* loop_p, uint64_t table_id, uint64_t conn_id, int move_code)
+{
+    char line[SERVER_MAX_OUT_LINE]; // The error to the client.
+    SERVER_TABLE* table_p = (SERVER_TABLE*) Slot_Pool_Get(&loop_p->tables, table_id); // The table.
+    const char* error = NULL; // The reason the move isn't played.
+
+    if (table_p == NULL || !table_p->is_started)
+        error = "the table isn't playing";
+    else if (table_p->seat_conns[table_p->game_data.player_index] != conn_id)
+        error = "not your turn";
+    else if (move_code < 0 || move_code >= NOF_MOVE_CODES || !(Ai_Get_Move_Codes(&table_p->game_data) & (1ULL << move_code)))
+        error = "illegal move";
+
+    if (error != NULL)
+    {
+        Server_Send(loop_p, conn_id, line, snprintf(line, sizeof(line), "ERR %llu %s\n", (unsigned long long) table_id, error), 0);
+        return;
+    }
+
+    Table_Play_Move(loop_p, table_p, Log_Decode_Move((unsigned char) move_code));
+    Table_Advance(loop_p, table_p);
+}
+
+
+/*
+ * Remove a client from its seats at a table, the server plays them from now on. A table without clients is closed.
+ * Receives a pointer to the table's loop, the table's id and the client's connection id.
+ */
+void Table_Leave(SERVER_LOOP* loop_p, uint64_t table_id, uint64_t conn_id)
+{
+    SERVER_TABLE* table_p = (SERVER_TABLE*) Slot_Pool_Get(&loop_p->tables, table_id); // The table.
+    bool has_clients = false; // True if a client still has a seat.
+
+    if (table_p == NULL)
+        return;
+
+    for (int seat_i = 0; seat_i < table_p->nof_humans; seat_i++)
+    {
+        if (table_p->seat_conns[seat_i] == conn_id)
+            table_p->seat_conns[seat_i] = 0;
+        has_clients |= table_p->seat_conns[seat_i] != 0;
+    }
+
+    if (!has_clients)
+        Table_Close(loop_p, table_p);
+    else if (table_p->is_started && table_p->seat_conns[table_p->game_data.player_index] == 0)
+        Table_Advance(loop_p, table_p);
+}
+
+
+/*
+ * Start the game of a table: tell its clients, and play until a client's turn.
+ * Receives a pointer to the table's loop and the table.
+ */
+void Table_Start(SERVER_LOOP* loop_p, SERVER_TABLE* table_p)
+{
+    char line[SERVER_MAX_OUT_LINE]; // The line to the clients.
+
+    table_p->is_started = true;
+    Table_Broadcast(loop_p, table_p, line, snprintf(line, sizeof(line), "START %llu\n", (unsigned long long) table_p->id), 0);
+    Table_Advance(loop_p, table_p);
+}
+
+
+/*
+ * Play a move of the current player, and tell the table's clients.
+ * Receives a pointer to the table's loop, the table, and a legal move.
+ */
+void Table_Play_Move(SERVER_LOOP* loop_p, SERVER_TABLE* table_p, MOVE move)
+{
+    char line[SERVER_MAX_OUT_LINE]; // The line to the clients.
+    int seat_i = table_p->game_data.player_index; // The player of the move.
+    unsigned char move_code = Log_Encode_Move(move, table_p->game_data.is_taki_open); // The move's code, before the move changes the sequence.
+
+    Engine_Apply_Move(&table_p->game_data, move);
+    loop_p->nof_moves++;
+    Table_Broadcast(loop_p, table_p, line,
+                    snprintf(line, sizeof(line), "MOVE %llu %d %d\n", (unsigned long long) table_p->id, seat_i, move_code), 0);
+}
+
+
+/*
+ * Run the table's state machine: play the turns of the server's seats until a client's turn, and send the client its turn.
+ * When the game ends, the clients get the winner and the table is closed.
+ * Receives a pointer to the table's loop and the table.
+ */
+void Table_Advance(SERVER_LOOP* loop_p, SERVER_TABLE* table_p)
+{
+    char line[SERVER_MAX_OUT_LINE]; // The line to the clients.
+
+    while (!table_p->game_data.is_game_won)
+    {
+        if (table_p->seat_conns[table_p->game_data.player_index] != 0)
+        {
+            Table_Send_Turn(loop_p, table_p);
+            return;
+        }
+
+        Table_Play_Move(loop_p, table_p, Choose_Auto_Move(&table_p->game_data, NULL));
+    }
+
+    loop_p->nof_games++;
+    Table_Broadcast(loop_p, table_p, line,
+                    snprintf(line, sizeof(line), "WIN %llu %d\n", (unsigned long long) table_p->id, table_p->game_data.winner_index), table_p->id);
+    Table_Close(loop_p, table_p);
+}
+
+
+/*
+ * Send the current player of a table its turn: the top card, the legal moves and its hand.
+ * Receives a pointer to the table's loop and the table.
+ */
+void Table_Send_Turn(SERVER_LOOP* loop_p, const SERVER_TABLE* table_p)
+{
+    const GAME_DATA* game_data_p = &table_p->game_data; // The game.
+    const HAND* hand_p = &game_data_p->players[game_data_p->player_index].hand; // The hand of the current player.
+    char line[SERVER_MAX_OUT_LINE]; // The line to the client.
+    int len; // The length of the line.
+
+    len = snprintf(line, sizeof(line), "TURN %llu %d %d %llx ", (unsigned long long) table_p->id, game_data_p->top_card,
+                   game_data_p->is_taki_open, (unsigned long long) Ai_Get_Move_Codes(game_data_p));
+
+    // The hand, a code for every card. A hand too long for the line is cut, only a game with a custom deck can have one.
+    for (uint64_t codes = hand_p->code_mask; codes != 0 && len < SERVER_MAX_OUT_LINE - 8; codes &= codes - 1)
+    {
+        int card_code = __builtin_ctzll(codes); // The card code.
+
+        for (uint32_t count_i = 0; count_i < hand_p->counts[card_code] && len < SERVER_MAX_OUT_LINE - 8; count_i++)
+            len += snprintf(&line[len], sizeof(line) - len, "%d,", card_code);
+    }
+    line[len - 1] = '\n'; // Instead of the last comma, or of the space of an empty hand.
+
+    Server_Send(loop_p, table_p->seat_conns[game_data_p->player_index], line, len, 0);
+}
+
+
+/*
+ * Send a line to all the clients of a table, once to every connection.
+ * Receives a pointer to the table's loop, the table, the line and its length,
+ * and a table to remove from the clients' tables (once for every seat), or 0.
+ */
+void Table_Broadcast(SERVER_LOOP* loop_p, const SERVER_TABLE* table_p, const char* line, int len, uint64_t done_table_id)
+{
+    for (int seat_i = 0; seat_i < table_p->nof_humans; seat_i++)
+    {
+        uint64_t conn_id = table_p->seat_conns[seat_i]; // The client of the seat.
+        bool is_sent = false; // True if the client already got the line for an earlier seat.
+
+        if (conn_id == 0)
+            continue;
+        for (int prev_i = 0; prev_i < seat_i; prev_i++)
+            is_sent |= table_p->seat_conns[prev_i] == conn_id;
+
+        if (!is_sent)
+            Server_Send(loop_p, conn_id, line, len, done_table_id);
+        else if (done_table_id != 0)
+            Server_Send(loop_p, conn_id, line, 0, done_table_id);
+    }
+}
+
+
+/*
+ * Close a table. Its memory is kept for the next table of its slot.
+ * Receives a pointer to the table's loop and the table.
+ */
+void Table_Close(SERVER_LOOP* loop_p, SERVER_TABLE* table_p)
+{
+    Engine_Free_Game(&table_p->game_data);
+    Arena_Reset(&table_p->arena);
+    Slot_Pool_Release(&loop_p->tables, table_p->id);
+}
+
+
+/*
+ * Free what a table holds, when its loop is freed.
+ * Receives a pointer to the table.
+ */
+void Table_Free(void* table_vp)
+{
+    Arena_Free(&((SERVER_TABLE*) table_vp)->arena);
+}
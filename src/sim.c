@@ -0,0 +1,372 @@
+#include "header.h"
+
+// -------------------- Simulation Functions ---------------------
+// Runs many games of automatic players on all the cores of the computer.
+// Every worker thread owns a range of game numbers, and takes games from its front.
+// A worker that finished its range steals the back half of the range of another worker, so all the workers stay busy until the last games.
+// Every worker allocates its games from its own arena, so after the first games the workers don't call malloc or free.
+// When the games are recorded, every worker builds the record of its game alone, and appends it to the shared log file when the game ends.
+// Seats played by policy plugins share one slot per seat between the workers, every game takes the slots' current policies when it starts.
+
+/*
+ * Run a batch of games with automatic players, and print the results.
+ * Receives a pointer to the simulation's settings. A number of threads of 0 uses all the cores of the computer.
+ * Game number i is played with the simulation's seed and stream i, so every game can be replayed alone.
+ * While it runs, SIGHUP loads the policy plugins again, and the games that start after it play with the new policies.
+ */
+void Run_Simulation(const SIM_CONFIG* config_p)
+{
+    SIM_WORKER* workers; // The workers, one for each thread.
+    SIM_RESULT total; // The merged results of all the workers.
+    LOG_WRITER log_writer; // The log file of the games, if they are recorded.
+    POLICY_SLOT policy_slots[MAX_SIM_PLAYERS]; // The policy plugins of the seats.
+    bool has_policies = false; // If any seat is played by a policy plugin.
+    struct timespec start_time, end_time; // The time the games started and finished.
+    double seconds; // The time it took to play all the games.
+    int nof_threads = config_p->nof_threads; // The number of worker threads.
+    long long games_per_worker, first_game = 0; // The number of games in the range of each worker, and the first game of the next range.
+
+    // Use all the cores of the computer if the number of threads wasn't set.
+    if (nof_threads <= 0)
+        nof_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (nof_threads <= 0)
+        nof_threads = 1;
+
+    // Try to allocate the workers, aligned to the cache lines so the workers don't share them.
+    workers = (SIM_WORKER*) aligned_alloc(CACHE_LINE_SIZE, sizeof(SIM_WORKER) * nof_threads);
+    if (workers == NULL)
+    {
+        printf("Memory allocation failed!!!\n");
+        exit(1);
+    }
+    memset(workers, 0, sizeof(SIM_WORKER) * nof_threads);
+
+    // Open the log file, if the games are recorded.
+    if (config_p->log_path != NULL && !Log_Open_Writer(&log_writer, config_p->log_path))
+    {
+        printf("Can't open the log file %s!!!\n", config_p->log_path);
+        exit(1);
+    }
+
+    // Load the policy plugins of the seats, and reload them on SIGHUP.
+    for (int seat_i = 0; seat_i < config_p->nof_players; seat_i++)
+    {
+        Policy_Slot_Init(&policy_slots[seat_i], config_p->policy_paths[seat_i]);
+        has_policies |= (config_p->policy_paths[seat_i] != NULL);
+    }
+    if (has_policies)
+        signal(SIGHUP, Policy_Request_Reload);
+
+    // Split the games evenly between the workers, the first workers get the remaining games.
+    games_per_worker = config_p->nof_games / nof_threads;
+    for (int worker_i = 0; worker_i < nof_threads; worker_i++)
+    {
+        long long nof_worker_games = games_per_worker + (worker_i < config_p->nof_games % nof_threads ? 1 : 0);
+
+        workers[worker_i].worker_i = worker_i;
+        workers[worker_i].nof_workers = nof_threads;
+        workers[worker_i].workers = workers;
+        workers[worker_i].config = *config_p;
+        workers[worker_i].log_writer_p = (config_p->log_path != NULL) ? &log_writer : NULL;
+        workers[worker_i].policy_slots = has_policies ? policy_slots : NULL;
+        Init_Sim_Result(&workers[worker_i].result, config_p->nof_players);
+        atomic_init(&workers[worker_i].range, Pack_Games_Range((uint32_t) first_game, (uint32_t) (first_game + nof_worker_games)));
+        first_game += nof_worker_games;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    // Start the worker threads, the first worker runs on this thread.
+    for (int worker_i = 1; worker_i < nof_threads; worker_i++)
+        pthread_create(&workers[worker_i].thread, NULL, Sim_Worker_Thread, &workers[worker_i]);
+    Sim_Worker_Thread(&workers[0]);
+    for (int worker_i = 1; worker_i < nof_threads; worker_i++)
+        pthread_join(workers[worker_i].thread, NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    seconds = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+
+    // Merge the results of every worker.
+    Init_Sim_Result(&total, config_p->nof_players);
+    for (int worker_i = 0; worker_i < nof_threads; worker_i++)
+        Merge_Sim_Result(&total, &workers[worker_i].result);
+
+    Print_Sim_Result(&total, nof_threads, seconds);
+
+    if (config_p->log_path != NULL)
+        Log_Close_Writer(&log_writer);
+    if (has_policies)
+        signal(SIGHUP, SIG_DFL);
+    for (int seat_i = 0; seat_i < config_p->nof_players; seat_i++)
+        Policy_Slot_Free(&policy_slots[seat_i]);
+    free(workers);
+}
+
+
+/*
+ * The main function of a worker thread.
+ * Plays the games of the worker's range, then steals games from the other workers until there are no games left.
+ * Receives a pointer to the worker (void* to match pthread_create).
+ */
+void* Sim_Worker_Thread(void* worker_vp)
+{
+    SIM_WORKER* worker_p = (SIM_WORKER*) worker_vp; // The worker running on this thread.
+    uint32_t game_i; // The number of the game to play.
+
+    Arena_Init(&worker_p->arena, ARENA_CHUNK_SIZE);
+    Log_Init(&worker_p->log, worker_p->log_writer_p);
+
+    while (true)
+    {
+        // Play the games of the worker's own range.
+        while (Take_Own_Game(worker_p, &game_i))
+            Play_Sim_Game(worker_p, game_i);
+
+        // The range is finished, steal more games. If no worker has games to steal, all the games were taken.
+        if (!Steal_Games(worker_p))
+        {
+            Arena_Free(&worker_p->arena);
+            Log_Free(&worker_p->log);
+            return NULL;
+        }
+    }
+}
+
+
+/*
+ * Play a single game of the simulation, and add it to the worker's results.
+ * The seats are played by their policy plugins, or by the automatic player.
+ * Receives a pointer to the worker and the number of the game.
+ */
+void Play_Sim_Game(SIM_WORKER* worker_p, uint32_t game_i)
+{
+    GAME_DATA game_data; // The game being played.
+    SIM_RESULT* result_p = &worker_p->result; // The results of this worker.
+    SEAT_POLICIES seats; // The policies of the game's seats.
+
+    // Start the game with the simulation's seed, and the game's number as the stream. The game's memory is taken from the worker's arena.
+    Engine_Init_Game(&game_data, worker_p->config.nof_players, worker_p->config.seed, game_i,
+                     worker_p->config.is_finite_deck ? STANDARD_DECK_COUNTS : NULL, &worker_p->arena);
+
+    // Record the game, the engine adds its moves and writes it when it ends.
+    if (worker_p->log_writer_p != NULL)
+        Log_Begin_Game(&worker_p->log, &game_data);
+
+    // Play turns until one of the players wins.
+    if (worker_p->policy_slots == NULL)
+    {
+        while (Engine_Step_Turn(&game_data, Choose_Auto_Move, NULL))
+            result_p->nof_turns++;
+    }
+    else
+    {
+        // The first game after SIGHUP loads the policies again, the games already playing keep their policies.
+        if (Policy_Take_Reload_Request())
+            for (int seat_i = 0; seat_i < worker_p->config.nof_players; seat_i++)
+                if (Policy_Slot_Reload(&worker_p->policy_slots[seat_i]))
+                    printf("Reloaded the policy %s of player %d\n", worker_p->policy_slots[seat_i].path, seat_i + 1);
+
+        Seat_Policies_Begin(&seats, worker_p->policy_slots, worker_p->config.nof_players, worker_p->config.seed ^ game_i);
+        while (Engine_Step_Turn(&game_data, Choose_Seat_Move, &seats))
+            result_p->nof_turns++;
+        Seat_Policies_End(&seats);
+    }
+    result_p->nof_turns++; // The winning turn.
+
+    // Add the game's results.
+    result_p->nof_games++;
+    result_p->seat_wins[game_data.winner_index]++;
+    Merge_Card_Stats(result_p->card_freqs, game_data.card_freqs);
+
+    Engine_Free_Game(&game_data);
+    Arena_Reset(&worker_p->arena); // All the memory of the game returns to the arena at once.
+}
+
+
+/*
+ * Take the next game from the front of the worker's own range.
+ * Receives a pointer to the worker and a pointer where the game's number will be saved.
+ * Returns true if a game was taken, false if the range is empty.
+ */
+bool Take_Own_Game(SIM_WORKER* worker_p, uint32_t* game_i_p)
+{
+    uint64_t range = atomic_load_explicit(&worker_p->range, memory_order_relaxed); // The current range, packed.
+    uint32_t first, end; // The first game of the range, and the game after the last game.
+
+    do
+    {
+        Unpack_Games_Range(range, &first, &end);
+        if (first >= end)
+            return false; // The range is empty.
+    }
+    // Move the front of the range, a thief may have shrunk the range from its back meanwhile.
+    while (!atomic_compare_exchange_weak_explicit(&worker_p->range, &range, Pack_Games_Range(first + 1, end),
+                                                  memory_order_acquire, memory_order_relaxed));
+
+    *game_i_p = first;
+    return true;
+}
+
+
+/*
+ * Steal the back half of the range of another worker, and make it the worker's own range.
+ * Checks the other workers one by one, starting from the worker after this one.
+ * Receives a pointer to the worker, whose own range is empty.
+ * Returns true if games were stolen, false if all the ranges are empty.
+ */
+bool Steal_Games(SIM_WORKER* worker_p)
+{
+    int nof_workers = worker_p->nof_workers; // The number of workers.
+
+    for (int step = 1; step < nof_workers; step++)
+    {
+        SIM_WORKER* victim_p = &worker_p->workers[(worker_p->worker_i + step) % nof_workers]; // The worker to steal from.
+        uint64_t range = atomic_load_explicit(&victim_p->range, memory_order_relaxed); // The victim's range, packed.
+        uint32_t first, end, middle; // The victim's range, and where it will be split.
+
+        while (true)
+        {
+            Unpack_Games_Range(range, &first, &end);
+            if (first >= end)
+                break; // Nothing to steal from this worker.
+
+            // Take the back half. A range of one game is taken completely, if the victim takes it first the exchange fails.
+            middle = first + (end - first) / 2;
+
+            // Shrink the victim's range, and try again if the victim's range changed meanwhile.
+            if (atomic_compare_exchange_weak_explicit(&victim_p->range, &range, Pack_Games_Range(first, middle),
+                                                      memory_order_acq_rel, memory_order_relaxed))
+            {
+                // Nobody steals from an empty range, so the worker's own range can be replaced.
+                atomic_store_explicit(&worker_p->range, Pack_Games_Range(middle, end), memory_order_release);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+/*
+ * Pack a range of games into one 64 bits number, so it can be changed with one atomic operation.
+ * Receives the first game of the range and the game after the last game.
+ */
+uint64_t Pack_Games_Range(uint32_t first, uint32_t end)
+{
+    return ((uint64_t) first << 32) | end;
+}
+
+
+/*
+ * Unpack a range of games packed with Pack_Games_Range.
+ * Receives the packed range, and pointers where the first game and the game after the last game will be saved.
+ */
+void Unpack_Games_Range(uint64_t range, uint32_t* first_p, uint32_t* end_p)
+{
+    *first_p = (uint32_t) (range >> 32);
+    *end_p = (uint32_t) range;
+}
+
+
+/*
+ * Initialize empty simulation results.
+ * Receives a pointer to the results and the number of players in every game.
+ */
+void Init_Sim_Result(SIM_RESULT* result_p, int nof_players)
+{
+    result_p->nof_games = 0;
+    result_p->nof_turns = 0;
+    result_p->nof_players = nof_players;
+
+    // The wins of every seat in the games.
+    for (int seat_i = 0; seat_i < MAX_SIM_PLAYERS; seat_i++)
+        result_p->seat_wins[seat_i] = 0;
+
+    // The cards drawn in all the games.
+    memset(result_p->card_freqs, 0, sizeof(result_p->card_freqs));
+}
+
+
+/*
+ * Add the results of one worker to the total results.
+ * Receives a pointer to the total results and a pointer to the results to add.
+ */
+void Merge_Sim_Result(SIM_RESULT* total_p, const SIM_RESULT* result_p)
+{
+    total_p->nof_games += result_p->nof_games;
+    total_p->nof_turns += result_p->nof_turns;
+
+    for (int seat_i = 0; seat_i < total_p->nof_players; seat_i++)
+        total_p->seat_wins[seat_i] += result_p->seat_wins[seat_i];
+
+    Merge_Card_Stats(total_p->card_freqs, result_p->card_freqs);
+}
+
+
+/*
+ * Print the results of the simulation: the speed, the wins of every seat and the statistics of the cards drawn.
+ * Receives a pointer to the results, the number of threads and the time it took in seconds.
+ */
+void Print_Sim_Result(SIM_RESULT* result_p, int nof_threads, double seconds)
+{
+    printf("\n************ Simulation Results ************\n");
+    printf("Games: %llu, Turns: %llu, Threads: %d\n", result_p->nof_games, result_p->nof_turns, nof_threads);
+
+    // Print how many games every seat won.
+    for (int seat_i = 0; seat_i < result_p->nof_players; seat_i++)
+        printf("Player %d won %llu games (%.2f%%)\n", seat_i + 1, result_p->seat_wins[seat_i],
+               result_p->nof_games ? 100.0 * result_p->seat_wins[seat_i] / result_p->nof_games : 0.0);
+
+    // Print the statistics of the cards drawn in all the games.
+    Print_Card_Stats(result_p->card_freqs);
+
+    // Print the speed of the simulation.
+    printf("\nTime: %.3f seconds, %.0f games/sec, %.0f turns/sec\n", seconds,
+           seconds > 0 ? result_p->nof_games / seconds : 0.0, seconds > 0 ? result_p->nof_turns / seconds : 0.0);
+}
+
+
+
+
+// ---------------------- Replay Functions -----------------------
+// Replays the games of a log file through the engine, to check that the log and the engine still agree.
+
+/*
+ * Replay every game of a log file through the engine, and print how many games were replayed exactly.
+ * Receives the path of the log file.
+ * Returns true if every game of the log was replayed exactly, false otherwise.
+ */
+bool Replay_Log_File(const char* path)
+{
+    LOG_READER reader; // The mapped log file.
+    LOGGED_GAME logged_game; // The game being replayed.
+    GAME_DATA game_data; // The replayed game.
+    unsigned long long nof_games = 0, nof_failed = 0; // The number of games in the log, and the number of games that didn't replay the same.
+
+    if (!Log_Open_Reader(&reader, path))
+    {
+        printf("%s is not a log of games!!!\n", path);
+        return false;
+    }
+
+    while (Log_Next_Game(&reader, &logged_game))
+    {
+        nof_games++;
+        if (!Log_Replay_Game(&logged_game, &game_data))
+            nof_failed++;
+        Engine_Free_Game(&game_data);
+    }
+
+    // Check if the log ended in the middle of a record.
+    if (reader.pos != reader.data + reader.size)
+    {
+        printf("The log has a broken record after game %llu!!!\n", nof_games);
+        nof_failed++;
+    }
+
+    printf("Replayed %llu games, %llu failed.\n", nof_games, nof_failed);
+    Log_Close_Reader(&reader);
+
+    return nof_failed == 0;
+}
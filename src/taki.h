@@ -0,0 +1,659 @@
+#ifndef TAKI_H // Include taki.h only once.
+#define TAKI_H
+
+// The public header of libtaki: the game's cards, the rules, the headless engine, the deck, the log and the computer player.
+// It has no input or output of its own, so a program can embed the engine without the terminal game. (header.h adds the game's screens and tools)
+
+// --------- Header Files ---------
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+// ----------- Constants ----------
+
+#define MAX_NAME_LEN 21 // The maximum length of the first name of each player. the maximum length is 20 charaters.
+
+#define NOF_START_CARDS 4 // How many cards each player starts the game with.
+
+#define EMPTY -1 // Empty card number will be represented by -1, so the card number value in the special cards will be initialized to -1.
+
+// Cards
+#define NUM_OF_COLORS 4 // The number of card colors in the game.
+#define NOF_CARD_TYPES 6 // Number of card types in the game.
+
+// Card codes: every card is encoded in one byte, see CARD below.
+#define NOF_NUMBERS 9 // Normal cards have a number from 1 to 9.
+#define NOF_COLORED_SPECIALS 4 // Special card types that have a color: "+" / "STOP" / "<->" / "TAKI".
+#define FIRST_NORMAL_CODE 0 // Normal cards: 0-35, (color - 1) * 9 + (number - 1).
+#define FIRST_SPECIAL_CODE (NUM_OF_COLORS * NOF_NUMBERS) // Colored special cards: 36-51, 36 + special index * 4 + (color - 1).
+#define FIRST_COLOR_CODE (FIRST_SPECIAL_CODE + NOF_COLORED_SPECIALS * NUM_OF_COLORS) // COLOR cards: 52-56, 52 + color (0 while no color was chosen).
+#define NOF_CARD_CODES (FIRST_COLOR_CODE + NUM_OF_COLORS + 1) // The number of different card codes (57).
+
+// Card code masks: bit i is set for the card code i. A hand and the cards that can be dropped are masks too.
+#define COLOR_CARDS_MASK (1ULL << FIRST_COLOR_CODE) // The COLOR card of a hand, before its color is chosen.
+#define SAME_COLOR_MASK(color) ((0x1FFULL << (FIRST_NORMAL_CODE + ((color) - 1) * NOF_NUMBERS)) | (0x1111ULL << (FIRST_SPECIAL_CODE + (color) - 1))) // The normal and special cards of a color.
+#define SAME_NUMBER_MASK(num) (0x8040201ULL << (FIRST_NORMAL_CODE + (num) - 1)) // The normal cards of a number, in all the colors.
+#define SAME_SPECIAL_MASK(special_i) (0xFULL << (FIRST_SPECIAL_CODE + (special_i) * NUM_OF_COLORS)) // A colored special card in all the colors.
+
+// Stats 
+#define GAME_STATS_MAX_SIZE 14 // The possible stats are for 9 number cards and 5 special cards, 14 in total.
+#define FIRST_SPECIAL_STAT NOF_NUMBERS // In the stats view, the stats of the number cards are first (by number), then the special cards (by type).
+#define NOF_CARD_KINDS GAME_STATS_MAX_SIZE // The kinds of cards, a kind is a card without its color: 9 numbers and 5 special types. (the same as the stats)
+
+// Threads
+#define CACHE_LINE_SIZE 64 // Data changed by different threads is kept on different cache lines.
+
+// Deck
+#define MAX_DECK_SIZE 128 // The maximum number of cards in a finite deck.
+#define DECK_ARRAY_SIZE (2 * MAX_DECK_SIZE) // The size of the deck's array. The piles never share places, so a reshuffle leaves the discard pile where it was.
+
+// Arena
+#define ARENA_ALIGNMENT 16 // Every block allocated from an arena starts on a multiple of this.
+#define ARENA_CHUNK_SIZE 4096 // The default size of an arena chunk in bytes, bigger allocations get their own chunk.
+
+// Game log definitions
+#define LOG_MAGIC "TAKILOG1" // The first bytes of every log file.
+#define LOG_MAGIC_LEN 8 // The length of the log's magic.
+#define MAX_VARINT_LEN 10 // The most bytes a varint of 64 bits takes.
+#define LOG_BUFFER_START_SIZE 256 // The first size of a game log's buffer, it doubles when it is full.
+#define LOG_DRAW NOF_CARD_CODES // The byte of a draw move, after the bytes of the dropped cards (the card codes).
+#define LOG_END_TAKI (NOF_CARD_CODES + 1) // The byte of closing a TAKI sequence.
+#define LOG_GAME_END (NOF_CARD_CODES + 2) // The byte after the last move of a game, followed by the winner.
+#define LOG_DECK_INFINITE 0 // The game was played with an infinite deck of random cards.
+#define LOG_DECK_STANDARD 1 // The game was played with the standard deck.
+#define LOG_DECK_CUSTOM 2 // The game was played with another deck, its counts follow.
+#define NOF_MOVE_CODES (LOG_END_TAKI + 1) // The number of different moves (Log_Encode_Move), every card code and color choice, drawing and closing a TAKI sequence.
+
+// AI definitions
+#define AI_PLAYER_NAME "AI" // A player with this name is played by the computer (Choose_Ai_Move).
+#define AI_MOVE_SECONDS 1.0 // How long the computer thinks about every move.
+#define AI_UCB_CONSTANT 0.7 // How much the search tries moves that were tried less, over the moves that won more.
+#define AI_ROLLOUT_MAX_MOVES 200 // A rollout that doesn't finish the game after this many moves is scored by the players' numbers of cards.
+#define AI_MAX_TREE_DEPTH 64 // The deepest move the search tree keeps, deeper moves are played by the rollout.
+#define AI_CLOCK_CHECK_MASK 15 // The time is checked once every 16 rollouts.
+#define AI_ARENA_CHUNK_SIZE (1 << 20) // The size of the chunks of the search trees' arenas, a tree gets a node for every rollout.
+
+
+// ---------- Data Stractures ----------
+
+// The types of cards, in the same order as their names in CARD_TYPE_NAMES: "+" / "STOP" / "<->" / "COLOR" / "TAKI" / "NORMAL".
+typedef enum Card_Type
+{
+    TYPE_PLUS,
+    TYPE_STOP,
+    TYPE_DIRECTION,
+    TYPE_COLOR,
+    TYPE_TAKI,
+    TYPE_NORMAL
+} CARD_TYPE;
+
+// The colors of the cards, numbered as in the color choice menu: 1 - Yellow, 2 - Red, 3 - Blue, 4 - Green.
+typedef enum Card_Color
+{
+    COLOR_NONE, // A COLOR card before its color was chosen.
+    COLOR_YELLOW,
+    COLOR_RED,
+    COLOR_BLUE,
+    COLOR_GREEN
+} CARD_COLOR;
+
+// A card, encoded in one byte as a card code from 0 to NOF_CARD_CODES - 1.
+// The type, color and number of a card code are read from CARD_INFO_TABLE, strings are used only when printing.
+typedef unsigned char CARD;
+
+// The characteristics of a card code.
+typedef struct Card_Info
+{
+    unsigned char type; // The card's type (CARD_TYPE).
+    unsigned char color; // The card's color (CARD_COLOR).
+    signed char num; // Containing a number from 1-9, EMPTY for special cards.
+} CARD_INFO;
+
+// Random numbers generator state (PCG32). Every game has its own generator, so games can run in parallel and be replayed from their seed.
+typedef struct Rng
+{
+    uint64_t state; // The current state, advanced on every random number.
+    uint64_t inc; // The stream of the generator (always odd). Generators with the same seed and different streams give independent sequences.
+} RNG;
+
+// The cards of a player, counted by card code (a multiset). Adding, removing and checking for a color or a kind doesn't depend on the number of cards.
+typedef struct Hand
+{
+    uint32_t counts[NOF_CARD_CODES]; // How many cards of every card code the player has.
+    uint32_t color_counts[NUM_OF_COLORS + 1]; // How many cards of every color (CARD_COLOR) the player has.
+    uint32_t kind_counts[NOF_CARD_KINDS]; // How many cards of every kind the player has.
+    uint64_t code_mask; // Bit i is set if the player has a card with the card code i.
+    uint32_t color_mask; // Bit i is set if the player has a card with the color i (CARD_COLOR).
+    uint32_t kind_mask; // Bit i is set if the player has a card of the kind i.
+    int nof_cards; // The number of cards that the player has.
+} HAND;
+
+// Player data containing his name and all the cards that in his possession.
+typedef struct Player
+{
+    char name[MAX_NAME_LEN]; // The name of the player. The maximum length of the name is MAX_NAME_LEN.
+    HAND hand; // The cards of the player.
+    CARD* cards; // The cards of the player in the order they are printed, built from the hand by Update_Cards_Array only when needed. The array is dynamic.
+    int cards_phys_size; // The physical size of the cards array.
+    bool is_cards_array_updated; // False when the hand has changed since the cards array was built.
+    bool is_computer; // True if the computer chooses the player's moves (Choose_Ai_Move).
+} PLAYER;
+
+// A chunk of memory of an arena, the blocks are allocated from its data one after the other.
+typedef struct Arena_Chunk
+{
+    struct Arena_Chunk* next; // The next chunk of the arena, NULL for the last chunk.
+    size_t size; // The size of the chunk's data in bytes.
+    size_t used; // How many bytes of the data were allocated since the last reset.
+    _Alignas(ARENA_ALIGNMENT) unsigned char data[]; // The memory of the chunk.
+} ARENA_CHUNK;
+
+// An arena allocator: hands out memory from chunks and frees all of it at once with Arena_Reset.
+typedef struct Arena
+{
+    ARENA_CHUNK* first; // The first chunk, NULL before the first allocation.
+    ARENA_CHUNK* current; // The chunk the next allocation is taken from.
+    size_t chunk_size; // The size of new chunks in bytes.
+    unsigned long long nof_system_allocs; // How many chunks were allocated with malloc.
+} ARENA;
+
+// Statistic data: The card number or type and the frequency of how many times that card was drawn.
+typedef struct Stat_Data
+{
+    CARD_TYPE card_type; // If card is "NORMAL" type, we use the card_num.
+    int card_num;
+    unsigned long long card_freq; // The number of times the card was drawn.
+} STAT_DATA;
+
+// A finite deck of cards. The draw pile is at the start of the cards array and the discard pile is at its end.
+typedef struct Deck
+{
+    CARD cards[DECK_ARRAY_SIZE]; // The draw pile in cards[0] to cards[nof_draw - 1] (the top is last), the discard pile in the last nof_discard places.
+    int nof_draw; // The number of cards in the draw pile.
+    int nof_discard; // The number of cards in the discard pile.
+    bool is_finite; // False for an infinite deck of random cards (Take_Random_Card), then the piles are unused.
+    const unsigned char* counts; // How many cards of every card code the deck has, NULL for an infinite deck. Not copied, the counts need to stay while the game is played.
+} DECK;
+
+// A log file that games are appended to. Shared by all the threads writing games.
+typedef struct Log_Writer
+{
+    int fd; // The file, opened for appending.
+} LOG_WRITER;
+
+// The record of the game being played, built in memory and written to the log file when the game ends. Every thread has its own.
+typedef struct Game_Log
+{
+    LOG_WRITER* writer_p; // The log file the games are written to, NULL to only build the records.
+    unsigned char* data; // The record of the game. The array is dynamic.
+    size_t len; // The number of bytes in the record.
+    size_t phys_size; // The physical size of the record's array.
+} GAME_LOG;
+
+// A log file mapped into memory for reading its games.
+typedef struct Log_Reader
+{
+    const unsigned char* data; // The mapped file.
+    size_t size; // The size of the file in bytes.
+    const unsigned char* pos; // The next record to read.
+} LOG_READER;
+
+// A game read from a log file. The deal, the moves and a custom deck point into the mapped file, they are never copied.
+typedef struct Logged_Game
+{
+    uint64_t seed; // The seed of the game's random numbers.
+    uint64_t stream; // The stream of the game's random numbers.
+    int nof_players; // The number of players in the game.
+    const unsigned char* deck_counts; // The deck of the game, NULL for an infinite deck.
+    CARD top_card; // The first top card.
+    const unsigned char* deal; // The start hands, for every player a varint number of cards then the card codes.
+    const unsigned char* moves; // The moves, a byte for every move (Log_Encode_Move).
+    int nof_moves; // The number of moves.
+    int winner_index; // The index of the player who won the game.
+} LOGGED_GAME;
+
+// Game data containing the players and the game's logic.
+typedef struct Game_Data
+{
+    PLAYER* players; // Pointer to array of all the players in the game.
+    ARENA* arena_p; // The arena the players and their cards are allocated from, NULL to allocate them with malloc.
+    int nof_players; // The number of players in the game.
+    int player_index; // The index of the player whose turn it is.
+    CARD top_card; // The card on the top of the deck.
+    DECK deck; // The cards that aren't in the players' hands or on the top of the deck.
+    bool is_direction_right; // True if the direction of the play is to the right, false if it is to the left.
+    uint64_t seed; // The seed of the game's random numbers, the same seed and moves replay the same game.
+    uint64_t stream; // The stream of the game's random numbers, games with different streams are independent.
+    RNG rng; // The game's random numbers generator.
+    bool is_game_won; // If the game has finished, one of the players dropped all his cards.
+    bool is_taki_open; // True while the current player is in the middle of a TAKI sequence, the turn continues until the sequence is closed.
+    int winner_index; // The index of the player who won the game, EMPTY while the game is not finished.
+    unsigned long long card_freqs[NOF_CARD_CODES]; // How many times every card code was drawn. The printed stats are built from it when needed.
+    GAME_LOG* log_p; // The log the game's moves are recorded to, NULL to not record the game.
+    CARD last_drawn_card; // The last card a player drew, kept for undoing the move that drew it (Engine_Unmake_Move).
+} GAME_DATA;
+
+// A copy of a whole game in one flat block: the game's data followed by its players. Has no pointers of its own, so it can be copied with a single memcpy.
+typedef struct Game_Snapshot
+{
+    GAME_DATA game_data; // The game's data. Its players pointer is set only when the snapshot is opened (Game_Snapshot_Open).
+    PLAYER players[]; // The players of the game, without their cards arrays.
+} GAME_SNAPSHOT;
+
+// A node of the search tree of the AI: a move, and the results of the rollouts that played it.
+typedef struct Ai_Node
+{
+    struct Ai_Node* first_child; // The first move tried after this move, NULL if none was tried.
+    struct Ai_Node* next_sibling; // The next move tried instead of this move.
+    uint64_t child_mask; // Bit i is set if the move code i has a child node.
+    double reward; // The sum of the rewards of the rollouts through this node, for the player who made the move.
+    uint32_t nof_visits; // How many rollouts went through this node.
+    uint32_t nof_avails; // How many times the move was legal when its parent was visited.
+    int player_index; // The player who made the move.
+    unsigned char move_code; // The move (Log_Encode_Move).
+} AI_NODE;
+
+// A thread of the AI's search, every worker grows its own tree from its own guesses of the hidden cards.
+typedef struct Ai_Worker
+{
+    _Alignas(CACHE_LINE_SIZE) ARENA arena; // The nodes of the tree, reset before every search.
+    AI_NODE* root_p; // The root of the tree, the position being searched.
+    GAME_SNAPSHOT* game_p; // The game of the current rollout, a guess of the searched game.
+    RNG rng; // The random numbers of the worker's guesses and rollouts.
+    unsigned long long nof_rollouts; // How many rollouts the last search played.
+    pthread_t thread; // The thread running the worker, the first worker runs on the thread that asks for a move.
+    struct Ai_Player* ai_p; // The AI the worker belongs to.
+} AI_WORKER;
+
+// A computer player: Information Set Monte Carlo Tree Search on a pool of threads that wait between the moves.
+// Every rollout guesses the cards the player can't see (the other hands and the draw pile), so the search never uses them.
+typedef struct Ai_Player
+{
+    AI_WORKER* workers; // The workers of the search.
+    int nof_workers; // The number of workers.
+    double seconds_per_move; // How long a search takes.
+    pthread_mutex_t mutex; // Protects the search's number and the number of busy workers.
+    pthread_cond_t start_cond; // Signaled when a search starts, or when the workers need to stop.
+    pthread_cond_t done_cond; // Signaled when the last busy worker finished its search.
+    unsigned long long search_i; // The number of the current search, a worker searches when it changes.
+    int nof_busy; // The number of workers that didn't finish the current search.
+    bool is_stopping; // True when the workers need to end their threads.
+    GAME_SNAPSHOT* root_game_p; // The searched game, the same for all the workers.
+    struct timespec deadline; // When the search needs to stop.
+} AI_PLAYER;
+
+// What a move changed in the game, saved by Engine_Make_Move so Engine_Unmake_Move can undo the move exactly.
+// A move drops at most one card and draws at most one card (a PLUS or STOP card that was the player's last card), both from the hand of the player who moved.
+typedef struct Undo_Record
+{
+    RNG rng; // The random numbers generator before the move, a draw or a reshuffle advances it.
+    int player_index; // The player who moved.
+    int winner_index; // The winner before the move.
+    int nof_draw; // The number of cards in the draw pile before the move.
+    int nof_discard; // The number of cards in the discard pile before the move.
+    CARD top_card; // The top card before the move.
+    CARD dropped_card; // The card the player dropped. Used only if is_card_dropped.
+    CARD drawn_card; // The card the player drew. Used only if is_card_drawn.
+    bool is_card_dropped; // True if the move dropped a card.
+    bool is_card_drawn; // True if the move drew a card.
+    bool is_direction_right; // The direction before the move.
+    bool is_taki_open; // If a TAKI sequence was open before the move.
+    bool is_game_won; // If the game was won before the move.
+    int nof_saved_cards; // How many places of the draw pile and of the discard pile were saved in the undo log, before a reshuffle overwrote them.
+} UNDO_RECORD;
+
+// The undo records of the moves made on a game, the last made move is undone first.
+typedef struct Undo_Log
+{
+    UNDO_RECORD* records; // The undo records, the last made move is last. The array is dynamic.
+    int nof_records; // The number of undo records.
+    int records_phys_size; // The physical size of the records array.
+    CARD* saved_cards; // The places of the draw pile saved before reshuffles, in the order of the moves. The array is dynamic.
+    int nof_saved_cards; // The number of saved places.
+    int saved_cards_phys_size; // The physical size of the saved cards array.
+} UNDO_LOG;
+
+// The kinds of moves a player can make on his turn.
+typedef enum Move_Kind
+{
+    MOVE_DRAW, // Take a new card from the deck, ends the turn.
+    MOVE_PLAY, // Drop one of the player's cards on top of the deck.
+    MOVE_END_TAKI // Close the open TAKI sequence, ends the turn.
+} MOVE_KIND;
+
+// A single decision of a player, applied to the game by the engine.
+typedef struct Move
+{
+    MOVE_KIND kind; // What the player wants to do.
+    CARD card; // The card to drop from the player's hand. Used only by MOVE_PLAY.
+    CARD_COLOR color; // The color chosen for a COLOR card. Used only when dropping a COLOR card outside of a TAKI sequence.
+} MOVE;
+
+// A function that chooses the next move of the current player.
+// Receives the game's data (read only) and the context pointer that was given to the engine, returns the chosen move.
+typedef MOVE (*CHOOSE_MOVE_FUNC)(const GAME_DATA* game_data_p, void* context_p);
+
+
+
+// ---------------- Card Encoding Functions -----------------
+
+extern const CARD_INFO CARD_INFO_TABLE[NOF_CARD_CODES]; // The type, color and number of every card code.
+extern const char* const CARD_TYPE_NAMES[NOF_CARD_TYPES]; // The printed name of every card type.
+extern const uint64_t PLAY_MASKS[NOF_CARD_CODES]; // The cards that can be dropped on every top card.
+extern const uint64_t TAKI_PLAY_MASKS[NUM_OF_COLORS + 1]; // The cards that can be dropped in a TAKI sequence of every color.
+
+CARD Make_Card(CARD_TYPE type, CARD_COLOR color, int num);
+
+// Get the type of a card.
+static inline CARD_TYPE Get_Card_Type(CARD card) { return (CARD_TYPE) CARD_INFO_TABLE[card].type; }
+
+// Get the color of a card.
+static inline CARD_COLOR Get_Card_Color(CARD card) { return (CARD_COLOR) CARD_INFO_TABLE[card].color; }
+
+// Get the number of a card, EMPTY for special cards.
+static inline int Get_Card_Num(CARD card) { return CARD_INFO_TABLE[card].num; }
+
+// Get the kind of a card (the card without its color): 0-8 for the numbers 1-9, then the special types.
+static inline int Get_Card_Kind(CARD card)
+{
+    return Get_Card_Type(card) == TYPE_NORMAL ? Get_Card_Num(card) - 1 : FIRST_SPECIAL_STAT + (int) Get_Card_Type(card);
+}
+
+
+// -------------------- Hand Functions ---------------------
+
+void Hand_Init(HAND* hand_p);
+
+int Hand_Get_Cards(const HAND* hand_p, CARD cards[]);
+
+// Add a card to the hand.
+static inline void Hand_Add(HAND* hand_p, CARD card)
+{
+    hand_p->counts[card]++;
+    hand_p->color_counts[Get_Card_Color(card)]++;
+    hand_p->kind_counts[Get_Card_Kind(card)]++;
+    hand_p->code_mask |= 1ULL << card;
+    hand_p->color_mask |= 1U << Get_Card_Color(card);
+    hand_p->kind_mask |= 1U << Get_Card_Kind(card);
+    hand_p->nof_cards++;
+}
+
+// Remove a card from the hand. The hand needs to have the card.
+static inline void Hand_Remove(HAND* hand_p, CARD card)
+{
+    // Clear the bit of every count that reaches 0.
+    if (--hand_p->counts[card] == 0)
+        hand_p->code_mask &= ~(1ULL << card);
+    if (--hand_p->color_counts[Get_Card_Color(card)] == 0)
+        hand_p->color_mask &= ~(1U << Get_Card_Color(card));
+    if (--hand_p->kind_counts[Get_Card_Kind(card)] == 0)
+        hand_p->kind_mask &= ~(1U << Get_Card_Kind(card));
+    hand_p->nof_cards--;
+}
+
+// Check if the hand has a card with the card code.
+static inline bool Hand_Has_Card(const HAND* hand_p, CARD card) { return (hand_p->code_mask >> card) & 1; }
+
+// Check if the hand has any card of the color.
+static inline bool Hand_Has_Color(const HAND* hand_p, CARD_COLOR color) { return (hand_p->color_mask >> color) & 1; }
+
+// Check if the hand has any card of the kind.
+static inline bool Hand_Has_Kind(const HAND* hand_p, int kind) { return (hand_p->kind_mask >> kind) & 1; }
+
+// ------------------ Game Setup Functions --------------------
+
+void Init_Game_Data(GAME_DATA* game_data_p, uint64_t seed, uint64_t stream, const unsigned char deck_counts[]);
+
+void Hand_Start_Cards(GAME_DATA* game_data_p, PLAYER players[], int nof_players);
+
+// ---------- Allocation and Initialization Functions ----------
+
+void Init_Allocate_Players(GAME_DATA* game_data_p);
+
+void Init_Allocate_Players_Cards(GAME_DATA* game_data_p, int size);
+
+void Update_Cards_Array(GAME_DATA* game_data_p, PLAYER* player_p);
+
+void Reallocate_Cards_Array(GAME_DATA* game_data_p, PLAYER* player_p, int size);
+
+void Free_Cards_Arrays(PLAYER players[], int nof_players);
+
+// -------------------- Randomize Functions ---------------------
+
+void Rng_Seed(RNG* rng_p, uint64_t seed, uint64_t stream);
+
+// Get the next random 32 bits number of the generator. (PCG32 XSH-RR)
+static inline uint32_t Rng_Next(RNG* rng_p)
+{
+    uint64_t old_state = rng_p->state;
+    uint32_t xor_shifted = (uint32_t) (((old_state >> 18) ^ old_state) >> 27);
+    uint32_t rotation = (uint32_t) (old_state >> 59);
+
+    rng_p->state = old_state * 6364136223846793005ULL + rng_p->inc;
+    return (xor_shifted >> rotation) | (xor_shifted << ((-rotation) & 31));
+}
+
+// Get a random number from 0 to bound (not included), without a division. The small bounds of the game make the bias negligible.
+static inline uint32_t Rng_Below(RNG* rng_p, uint32_t bound)
+{
+    return (uint32_t) (((uint64_t) Rng_Next(rng_p) * bound) >> 32);
+}
+
+bool Take_Card(GAME_DATA* game_data_p, CARD* result_card_p);
+
+void Take_Random_Card(RNG* rng_p, CARD* result_card_p);
+
+void Get_Random_Normal_Card(RNG* rng_p, CARD* result_card_p);
+
+CARD_COLOR Get_Random_Color(RNG* rng_p);
+
+// -------------------- Play Cards Functions --------------------
+
+// Get the cards of the current player that can be dropped on the top card, as a mask of card codes.
+// A single lookup in the play masks, for any number of cards in the player's hand.
+static inline uint64_t Get_Legal_Plays(const GAME_DATA* game_data_p)
+{
+    uint64_t plays = game_data_p->is_taki_open ? TAKI_PLAY_MASKS[Get_Card_Color(game_data_p->top_card)] : PLAY_MASKS[game_data_p->top_card];
+
+    return plays & game_data_p->players[game_data_p->player_index].hand.code_mask;
+}
+
+bool Check_Normal_Card(CARD normal_card, CARD top_card);
+
+bool Check_Special_Card(CARD special_card, CARD top_card);
+
+bool Check_Taki_Card(CARD card, CARD top_card);
+
+bool Check_Play_Card(const GAME_DATA* game_data_p, CARD card, CARD_COLOR color);
+
+bool Is_Valid_Color(CARD_COLOR color);
+
+bool Try_Play_Card(GAME_DATA* game_data_p, PLAYER* player_p, CARD card, CARD_COLOR color);
+
+void Play_Card_Effect(GAME_DATA* game_data_p, PLAYER* player_p, CARD card);
+
+void Play_Color_Card(GAME_DATA* game_data_p, CARD_COLOR color);
+
+void Play_Stop_Card(GAME_DATA* game_data_p, PLAYER* player_p);
+
+void Play_Direction_Card(GAME_DATA* game_data_p);
+
+void Play_Taki_Card(GAME_DATA* game_data_p, PLAYER* player_p);
+
+void Close_Taki_Sequence(GAME_DATA* game_data_p, PLAYER* player_p);
+
+void Play_Plus_Card(GAME_DATA* game_data_p, PLAYER* player_p);
+
+void Remove_Card_From_Hand(GAME_DATA* game_data_p, PLAYER* player_p, CARD card);
+
+void Draw_New_Card(GAME_DATA* game_data_p, PLAYER* player_p);
+
+// ------------------- Statistics Functions --------------------
+
+// Count a card that was drawn. The frequency table is indexed by the card code, so this is a single increment.
+static inline void Add_Card_Stat(GAME_DATA* game_data_p, CARD card) { game_data_p->card_freqs[card]++; }
+
+int Build_Stats_View(const unsigned long long card_freqs[], STAT_DATA stats[]);
+
+void Sort_Stats_Array(STAT_DATA stats[], int nof_stats);
+
+void Merge_Card_Stats(unsigned long long total_freqs[], const unsigned long long card_freqs[]);
+
+// ----------------- Headless Engine Functions -----------------
+
+#define MAX_LEGAL_MOVES (NOF_CARD_CODES + 1) // The most legal moves a player can have: one for every card code, and drawing a card (or closing the TAKI sequence).
+
+void Engine_Init_Game(GAME_DATA* game_data_p, int nof_players, uint64_t seed, uint64_t stream, const unsigned char deck_counts[], ARENA* arena_p);
+
+void Engine_Free_Game(GAME_DATA* game_data_p);
+
+bool Engine_Is_Legal_Move(const GAME_DATA* game_data_p, MOVE move);
+
+int Engine_Get_Legal_Moves(const GAME_DATA* game_data_p, MOVE moves[]);
+
+bool Engine_Apply_Move(GAME_DATA* game_data_p, MOVE move);
+
+MOVE Engine_Default_Move(const GAME_DATA* game_data_p);
+
+bool Engine_Step_Turn(GAME_DATA* game_data_p, CHOOSE_MOVE_FUNC choose_move, void* context_p);
+
+int Engine_Play_Game(GAME_DATA* game_data_p, CHOOSE_MOVE_FUNC choose_move, void* context_p);
+
+int Engine_Get_Winner(const GAME_DATA* game_data_p);
+
+void Engine_Next_Turn(GAME_DATA* game_data_p);
+
+MOVE Choose_Auto_Move(const GAME_DATA* game_data_p, void* context_p);
+
+// ------------------- Make/Unmake Functions --------------------
+
+void Undo_Log_Init(UNDO_LOG* undo_log_p);
+
+void Undo_Log_Free(UNDO_LOG* undo_log_p);
+
+void Undo_Log_Reserve(UNDO_LOG* undo_log_p, int nof_saved_cards);
+
+bool Engine_Make_Move(GAME_DATA* game_data_p, MOVE move, UNDO_LOG* undo_log_p);
+
+bool Engine_Unmake_Move(GAME_DATA* game_data_p, UNDO_LOG* undo_log_p);
+
+// -------------------- Snapshot Functions ---------------------
+
+size_t Game_Snapshot_Size(int nof_players);
+
+void Game_Snapshot(const GAME_DATA* game_data_p, GAME_SNAPSHOT* snapshot_p);
+
+void Game_Restore(GAME_DATA* game_data_p, const GAME_SNAPSHOT* snapshot_p);
+
+GAME_DATA* Game_Clone(GAME_SNAPSHOT* dest_p, const GAME_SNAPSHOT* src_p);
+
+GAME_DATA* Game_Snapshot_Open(GAME_SNAPSHOT* snapshot_p);
+
+// ---------------------- Deck Functions -----------------------
+
+extern const unsigned char STANDARD_DECK_COUNTS[NOF_CARD_CODES]; // How many cards of every card code the standard deck has.
+
+void Deck_Init(DECK* deck_p, const unsigned char deck_counts[], RNG* rng_p);
+
+bool Deck_Draw(DECK* deck_p, RNG* rng_p, CARD* result_card_p);
+
+bool Deck_Draw_Normal_Card(DECK* deck_p, RNG* rng_p, CARD* result_card_p);
+
+void Deck_Discard(DECK* deck_p, CARD card);
+
+void Deck_Reshuffle(DECK* deck_p, RNG* rng_p);
+
+void Shuffle_Cards(CARD cards[], int nof_cards, RNG* rng_p);
+
+// ---------------------- Arena Functions -----------------------
+
+void Arena_Init(ARENA* arena_p, size_t chunk_size);
+
+void* Arena_Alloc(ARENA* arena_p, size_t size);
+
+void* Arena_Grow(ARENA* arena_p, void* block, size_t old_size, size_t new_size);
+
+void Arena_Reset(ARENA* arena_p);
+
+void Arena_Free(ARENA* arena_p);
+
+ARENA_CHUNK* Arena_New_Chunk(ARENA* arena_p, size_t size);
+
+// Round a size up to a multiple of ARENA_ALIGNMENT, so the next block is aligned too.
+static inline size_t Arena_Align_Size(size_t size) { return (size + ARENA_ALIGNMENT - 1) & ~(size_t) (ARENA_ALIGNMENT - 1); }
+
+// ------------------------ AI Functions --------------------------
+
+void Ai_Init(AI_PLAYER* ai_p, int nof_threads, double seconds_per_move, uint64_t seed);
+
+void Ai_Free(AI_PLAYER* ai_p);
+
+MOVE Choose_Ai_Move(const GAME_DATA* game_data_p, void* context_p);
+
+void* Ai_Worker_Thread(void* worker_vp);
+
+void Ai_Search(AI_WORKER* worker_p);
+
+void Ai_Rollout_Once(AI_WORKER* worker_p);
+
+void Ai_Guess_Hidden_Cards(GAME_DATA* game_data_p, int player_index, RNG* rng_p);
+
+void Ai_Play_Rollout(GAME_DATA* game_data_p, RNG* rng_p, double rewards[]);
+
+AI_NODE* Ai_Select_Child(AI_NODE* node_p, uint64_t move_codes);
+
+AI_NODE* Ai_Add_Child(AI_WORKER* worker_p, AI_NODE* node_p, unsigned char move_code, int player_index);
+
+uint64_t Ai_Get_Move_Codes(const GAME_DATA* game_data_p);
+
+CARD_COLOR Ai_Best_Color(const HAND* hand_p, CARD top_card);
+
+// Pick a random set bit of a mask, the mask must not be 0.
+static inline int Pick_Random_Bit(uint64_t mask, RNG* rng_p)
+{
+    for (uint32_t skip = Rng_Below(rng_p, (uint32_t) __builtin_popcountll(mask)); skip > 0; skip--)
+        mask &= mask - 1; // Clear the lowest set bit.
+
+    return __builtin_ctzll(mask);
+}
+
+// ---------------------- Game Log Functions -----------------------
+
+bool Log_Open_Writer(LOG_WRITER* writer_p, const char* path);
+
+void Log_Close_Writer(LOG_WRITER* writer_p);
+
+void Log_Init(GAME_LOG* log_p, LOG_WRITER* writer_p);
+
+void Log_Free(GAME_LOG* log_p);
+
+void Log_Begin_Game(GAME_LOG* log_p, GAME_DATA* game_data_p);
+
+void Log_Move(GAME_LOG* log_p, MOVE move, bool is_taki_open);
+
+void Log_End_Game(GAME_LOG* log_p, int winner_index);
+
+unsigned char Log_Encode_Move(MOVE move, bool is_taki_open);
+
+MOVE Log_Decode_Move(unsigned char move_byte);
+
+void Log_Put_Byte(GAME_LOG* log_p, unsigned char byte);
+
+void Log_Put_Varint(GAME_LOG* log_p, uint64_t value);
+
+int Encode_Varint(uint64_t value, unsigned char bytes[]);
+
+bool Decode_Varint(const unsigned char** pos_p, const unsigned char* end, uint64_t* value_p);
+
+bool Log_Open_Reader(LOG_READER* reader_p, const char* path);
+
+void Log_Close_Reader(LOG_READER* reader_p);
+
+bool Log_Next_Game(LOG_READER* reader_p, LOGGED_GAME* game_p);
+
+bool Log_Replay_Game(const LOGGED_GAME* logged_p, GAME_DATA* game_data_p);
+
+#endif // TAKI_H end if.
@@ -0,0 +1,66 @@
+#ifndef TAKI_POLICY_H // Include taki_policy.h only once.
+#define TAKI_POLICY_H
+
+// The C ABI of a player policy plugin: a shared object that chooses the moves of a player.
+// A plugin includes only this file, and exports the function TAKI_POLICY_ENTRY that returns its TAKI_POLICY table.
+// Build a plugin with: gcc -shared -fPIC -o my_policy.so my_policy.c
+// The game never passes its own structures to a plugin, only a pointer to a TAKI_POLICY_VIEW built for the call.
+
+// --------- Header Files ---------
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ----------- Constants ----------
+
+#define TAKI_POLICY_ABI_VERSION 1 // Changes whenever the view, the table or the card codes change. A plugin of another version isn't loaded.
+#define TAKI_POLICY_ENTRY "Taki_Get_Policy" // The name of the function the plugin exports (TAKI_GET_POLICY_FUNC).
+#define TAKI_MAX_PLAYERS 16 // The most players in a game played by plugins.
+#define TAKI_NO_CARD -1 // Returned by choose_card to drop no card: draw a card, or close the TAKI sequence.
+
+// The card codes:
+// 0-35  normal cards, (color - 1) * 9 + (number - 1)
+// 36-51 colored special cards, 36 + special * 4 + (color - 1), the specials are "+" (0), "STOP" (1), "<->" (2) and "TAKI" (3)
+// 52    the COLOR card in a hand, 53-56 a COLOR card on the top of the deck with its chosen color (52 + color)
+// The colors: yellow (1), red (2), blue (3) and green (4).
+#define TAKI_NOF_CARD_CODES 57 // The number of different card codes.
+#define TAKI_FIRST_SPECIAL_CODE 36 // The card code of the first colored special card.
+#define TAKI_COLOR_CARD_CODE 52 // The card code of the COLOR card.
+
+// ---------- Data Stractures ----------
+
+// What the current player can see of the game, built for every call. The pointers are valid only during the call.
+typedef struct Taki_Policy_View
+{
+    uint32_t abi_version; // TAKI_POLICY_ABI_VERSION of the game.
+    int nof_players; // The number of players in the game.
+    int player_index; // The index of the current player, the player the policy plays.
+    int top_card; // The card code of the card on the top of the deck.
+    bool is_taki_open; // True while the player is in the middle of a TAKI sequence.
+    bool is_direction_right; // The direction of the game.
+    const uint32_t* hand_counts; // How many cards of every card code the player has (TAKI_NOF_CARD_CODES counts), read only.
+    int nof_hand_cards; // The number of cards of the player.
+    uint64_t legal_plays; // Bit i is set if the player can drop a card with the card code i now.
+    int nof_cards[TAKI_MAX_PLAYERS]; // The number of cards of every player.
+    int nof_draw_cards; // The number of cards in the draw pile, -1 for an infinite deck.
+    int nof_discard_cards; // The number of cards in the discard pile.
+} TAKI_POLICY_VIEW;
+
+// The functions of a policy. Only choose_card is needed, the game uses a default for every other function that is NULL.
+// The state is created for every game of every player the policy plays, so a policy can keep what it learned during a game.
+typedef struct Taki_Policy
+{
+    uint32_t abi_version; // Must be TAKI_POLICY_ABI_VERSION.
+    const char* name; // The name of the policy.
+    void* (*create)(uint64_t seed); // Create the state of a game. NULL: the state is NULL.
+    void (*destroy)(void* state); // Free the state at the end of the game. NULL: nothing is freed.
+    int (*choose_card)(void* state, const TAKI_POLICY_VIEW* view); // Choose a card code of legal_plays to drop, or TAKI_NO_CARD.
+    int (*choose_color)(void* state, const TAKI_POLICY_VIEW* view); // Choose the color (1-4) of the COLOR card choose_card chose. NULL: the color of the top card.
+    bool (*continue_taki)(void* state, const TAKI_POLICY_VIEW* view); // In a TAKI sequence: true to drop another card, false to close it. NULL: always true.
+    bool (*choose_draw)(void* state, const TAKI_POLICY_VIEW* view); // Outside of a TAKI sequence: true to draw a card even if a card can be dropped. NULL: always false.
+} TAKI_POLICY;
+
+// The function the plugin exports, returns the policy's table. The table needs to stay valid while the plugin is loaded.
+typedef const TAKI_POLICY* (*TAKI_GET_POLICY_FUNC)(void);
+
+#endif // TAKI_POLICY_H end if.
@@ -0,0 +1,40 @@
+#include "header.h"
+
+/*
+ * The server: hosts many tables of clients and automatic players in one process, or runs a load generator against a server.
+ * Usage: taki_server [address] [event loops]
+ *        taki_server load [address] [connections] [tables per connection] [seconds] [players] [threads]
+ * An address is a TCP port on the loopback address, host:port, or the path of a Unix socket (it has a '/').
+ */
+int main(int argc, char* argv[])
+{
+    LOAD_CONFIG config; // The load generator's settings.
+
+    // Load mode: plays games on a server as fast as it answers, and prints the throughput and the latencies.
+    if (argc > 1 && !strcmp(argv[1], "load"))
+    {
+        config.address = argc > 2 ? argv[2] : SERVER_DEFAULT_ADDRESS;
+        config.nof_conns = argc > 3 ? atoi(argv[3]) : 64;
+        config.nof_tables = argc > 4 ? atoi(argv[4]) : 160;
+        config.seconds = argc > 5 ? atof(argv[5]) : LOAD_DEFAULT_SECONDS;
+        config.nof_players = argc > 6 ? atoi(argv[6]) : 4;
+        config.nof_threads = argc > 7 ? atoi(argv[7]) : 0;
+
+        if (config.nof_conns < 1 || config.nof_tables < 1 || config.seconds <= 0 || config.nof_players < 2 || config.nof_players > MAX_SIM_PLAYERS)
+        {
+            printf("Usage: taki_server load [address] [connections] [tables per connection] [seconds] [players 2-%d] [threads]\n", MAX_SIM_PLAYERS);
+            return 1;
+        }
+
+        return Run_Load(&config) ? 0 : 1;
+    }
+
+    if (argc > 3 || (argc > 2 && atoi(argv[2]) < 0))
+    {
+        printf("Usage: taki_server [address] [event loops]\n");
+        printf("       taki_server load [address] [connections] [tables per connection] [seconds] [players] [threads]\n");
+        return 1;
+    }
+
+    return Run_Server(argc > 1 ? argv[1] : SERVER_DEFAULT_ADDRESS, argc > 2 ? atoi(argv[2]) : 0) ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+#include "header.h"
+
+/*
+ * The simulator: plays many games of automatic players or policy plugins on all the cores, or replays a log of games.
+ * Usage: taki_sim <games> [players] [threads] [seed] [finite/infinite] [log file|-] [policy of every seat: plugin.so|auto ...]
+ *        taki_sim replay <log file>
+ */
+int main(int argc, char* argv[])
+{
+    SIM_CONFIG config; // The simulation's settings.
+
+    // Replay mode: taki_sim replay <log file>. Replays every game of a log file through the engine, and checks that it ends the same.
+    if (argc > 1 && !strcmp(argv[1], "replay"))
+    {
+        if (argc < 3)
+        {
+            printf("Usage: taki_sim replay <log file>\n");
+            return 1;
+        }
+
+        return Replay_Log_File(argv[2]) ? 0 : 1;
+    }
+
+    config.nof_games = argc > 1 ? atoll(argv[1]) : 100000;
+    config.nof_players = argc > 2 ? atoi(argv[2]) : 4;
+    config.nof_threads = argc > 3 ? atoi(argv[3]) : 0;
+    config.seed = argc > 4 ? strtoull(argv[4], NULL, 10) : (uint64_t) time(NULL);
+    config.is_finite_deck = argc > 5 ? strcmp(argv[5], "infinite") != 0 : true;
+    config.log_path = (argc > 6 && strcmp(argv[6], "-") != 0) ? argv[6] : NULL;
+
+    // The policy of every seat, the seats without a policy are played by the automatic player.
+    for (int seat_i = 0; seat_i < MAX_SIM_PLAYERS; seat_i++)
+        config.policy_paths[seat_i] = (argc > 7 + seat_i && strcmp(argv[7 + seat_i], "auto") != 0) ? argv[7 + seat_i] : NULL;
+
+    // Check the settings, the games are numbered with 32 bits.
+    if (config.nof_games < 0 || config.nof_games > UINT32_MAX || config.nof_players < 2 || config.nof_players > MAX_SIM_PLAYERS
+        || (argc > 5 && strcmp(argv[5], "finite") != 0 && strcmp(argv[5], "infinite") != 0) || argc > 7 + config.nof_players)
+    {
+        printf("Usage: taki_sim <games> [players 2-%d] [threads] [seed] [finite/infinite] [log file|-] [plugin.so|auto for every player]\n", MAX_SIM_PLAYERS);
+        printf("       taki_sim replay <log file>\n");
+        return 1;
+    }
+
+    printf("Simulating %lld games of %d players, seed %llu\n", config.nof_games, config.nof_players, (unsigned long long) config.seed);
+    Run_Simulation(&config);
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include "header.h"
+
+// -------------------- TUI Functions ---------------------
+// A full screen mode for the keyboard game. The top of the screen shows the top card and the cards of the current player in their colors,
+// and the bottom lines of the screen are left for the questions and the answers of the players.
+// Every turn the screen is composed into a grid of cells. Only the cells that are different from the cells already on the screen are written,
+// so a new top card or a dropped card costs a few cursor moves instead of the whole screen.
+
+// The ANSI color of every card color (CARD_COLOR): the default color, yellow, red, blue and green.
+const int ANSI_COLOR_CODES[NUM_OF_COLORS + 1] = { 0, 33, 31, 34, 32 };
+
+/*
+ * Start the full screen mode: clear the screen and keep the questions in the bottom lines.
+ * Receives a pointer to the TUI.
+ * If the allocation of the cells failed, prints error message and ends the program.
+ */
+void Tui_Init(TUI* tui_p)
+{
+    struct winsize window_size; // The size of the terminal.
+    int nof_screen_rows = DEFAULT_SCREEN_HEIGHT; // The number of lines of the screen.
+
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &window_size) == 0 && window_size.ws_row > 0)
+        nof_screen_rows = window_size.ws_row;
+
+    // The board is above the lines of the questions, it gets at least one card's lines.
+    tui_p->nof_rows = nof_screen_rows - TUI_PROMPT_LINES;
+    if (tui_p->nof_rows < CARD_LENGTH + 1)
+        tui_p->nof_rows = CARD_LENGTH + 1;
+    tui_p->nof_cols = Get_Screen_Width();
+
+    // Try to allocate the cells of the composed board and of the board on the screen.
+    tui_p->cells = (SCREEN_CELL*) malloc(sizeof(SCREEN_CELL) * tui_p->nof_rows * tui_p->nof_cols);
+    tui_p->shown_cells = (SCREEN_CELL*) malloc(sizeof(SCREEN_CELL) * tui_p->nof_rows * tui_p->nof_cols);
+
+    // Check if the allocation failed.
+    if (tui_p->cells == NULL || tui_p->shown_cells == NULL)
+    {
+        printf("Memory allocation failed!!!\n");
+        exit(1); // Stop the program.
+    }
+
+    // The screen starts empty.
+    Tui_Clear(tui_p);
+    memcpy(tui_p->shown_cells, tui_p->cells, sizeof(SCREEN_CELL) * tui_p->nof_rows * tui_p->nof_cols);
+
+    // Clear the screen, and scroll only the lines below the board, so the questions never move the board.
+    Frame_Init(&tui_p->frame);
+    Frame_Printf(&tui_p->frame, ANSI_ESC "[H" ANSI_ESC "[2J" ANSI_ESC "[%d;%dr", tui_p->nof_rows + 1, nof_screen_rows);
+    Frame_Printf(&tui_p->frame, ANSI_ESC "[%d;1H", tui_p->nof_rows + 1);
+    Frame_Flush(&tui_p->frame);
+}
+
+
+/*
+ * Finish the full screen mode: let the whole screen scroll again, and free the cells.
+ * The board stays on the screen.
+ * Receives a pointer to the TUI.
+ */
+void Tui_Free(TUI* tui_p)
+{
+    Frame_Put_Str(&tui_p->frame, ANSI_ESC "[r" ANSI_ESC "[0m");
+    Frame_Printf(&tui_p->frame, ANSI_ESC "[%d;1H", tui_p->nof_rows + TUI_PROMPT_LINES);
+    Frame_Flush(&tui_p->frame);
+
+    free(tui_p->cells);
+    free(tui_p->shown_cells);
+}
+
+
+/*
+ * Fill the composed board with spaces.
+ * Receives a pointer to the TUI.
+ */
+void Tui_Clear(TUI* tui_p)
+{
+    for (int cell_i = 0; cell_i < tui_p->nof_rows * tui_p->nof_cols; cell_i++)
+    {
+        tui_p->cells[cell_i].ch = ' ';
+        tui_p->cells[cell_i].color = COLOR_NONE;
+    }
+}
+
+
+/*
+ * Put text in the composed board. The characters outside of the board are cut.
+ * Receives a pointer to the TUI, the row and collum of the first character, the text, its length and its color (CARD_COLOR).
+ */
+void Tui_Put_Text(TUI* tui_p, int row, int col, const char* text, int len, CARD_COLOR color)
+{
+    if (row < 0 || row >= tui_p->nof_rows)
+        return;
+
+    for (int char_i = 0; char_i < len && col + char_i < tui_p->nof_cols; char_i++)
+    {
+        SCREEN_CELL* cell_p = &tui_p->cells[row * tui_p->nof_cols + col + char_i]; // The cell of the character.
+
+        cell_p->ch = text[char_i];
+        cell_p->color = (unsigned char) (text[char_i] == ' ' ? COLOR_NONE : color); // A space looks the same in every color.
+    }
+}
+
+
+/*
+ * Put a card in the composed board, in the card's color.
+ * Receives a pointer to the TUI, the row and collum of the card's top left corner, and the card.
+ */
+void Tui_Put_Card(TUI* tui_p, int row, int col, CARD card)
+{
+    const CARD_GLYPH* glyph_p = Get_Card_Glyph(card); // The drawing of the card.
+
+    for (int line = 0; line < CARD_LENGTH; line++)
+        Tui_Put_Text(tui_p, row + line, col, glyph_p->rows[line], CARD_WIDTH, Get_Card_Color(card));
+}
+
+
+/*
+ * Compose the board of a turn: the top card, the player's name and all of his cards side by side, then show it.
+ * Receives a pointer to the TUI, the top card and a pointer to the player, the player's cards array needs to be updated (Update_Cards_Array).
+ */
+void Tui_Draw_Deck(TUI* tui_p, CARD top_card, const PLAYER* player_p)
+{
+    char line[FRAME_LINE_SIZE]; // A line of text of the board.
+    int nof_cols = (tui_p->nof_cols + CARD_GAP) / (CARD_WIDTH + CARD_GAP); // How many cards fit side by side.
+    int row = 0; // The row of the board being composed.
+
+    if (nof_cols < 1)
+        nof_cols = 1;
+
+    Tui_Clear(tui_p);
+
+    // The card on top of the deck.
+    Tui_Put_Text(tui_p, row++, 0, "Upper card:", (int) strlen("Upper card:"), COLOR_NONE);
+    Tui_Put_Card(tui_p, row, 0, top_card);
+    row += CARD_LENGTH + 1;
+
+    // The name of the player currently playing, and his number of cards. (the cards that don't fit the board are cut)
+    Tui_Put_Text(tui_p, row++, 0, line, snprintf(line, sizeof(line), "%s's turn: (%d cards)", player_p->name, player_p->hand.nof_cards), COLOR_NONE);
+
+    // The cards of the player, a row of numbers above every row of cards.
+    for (int card_i = 0; card_i < player_p->hand.nof_cards; card_i++)
+    {
+        int col = (card_i % nof_cols) * (CARD_WIDTH + CARD_GAP); // The collum of the card.
+
+        // Move to the next row of cards after the last card of the row.
+        if (card_i > 0 && card_i % nof_cols == 0)
+            row += CARD_LENGTH + 2;
+
+        Tui_Put_Text(tui_p, row + 1, col, line, snprintf(line, sizeof(line), "Card #%d", card_i + 1), COLOR_NONE);
+        Tui_Put_Card(tui_p, row + 2, col, player_p->cards[card_i]);
+    }
+
+    Tui_Show(tui_p);
+}
+
+
+/*
+ * Write the cells of the composed board that are different from the cells on the screen, then move the cursor back to the questions.
+ * The cursor is moved only when the next changed cell isn't right after the last written cell, and the color is set only when it changes.
+ * Receives a pointer to the TUI.
+ */
+void Tui_Show(TUI* tui_p)
+{
+    int cursor_row = EMPTY, cursor_col = EMPTY; // Where the next written character will be, unknown at the start.
+    int color = EMPTY; // The color of the written characters, unknown at the start.
+
+    for (int row = 0; row < tui_p->nof_rows; row++)
+    {
+        for (int col = 0; col < tui_p->nof_cols; col++)
+        {
+            int cell_i = row * tui_p->nof_cols + col; // The index of the cell.
+            SCREEN_CELL cell = tui_p->cells[cell_i]; // The composed cell.
+
+            // Skip the cells that are already on the screen.
+            if (cell.ch == tui_p->shown_cells[cell_i].ch && cell.color == tui_p->shown_cells[cell_i].color)
+                continue;
+
+            // Move the cursor to the cell. (the screen's rows and collums start at 1)
+            // A short gap of unchanged cells on the same row is cheaper to write again than to move over.
+            if (row != cursor_row || col < cursor_col || !Tui_Rewrite_Gap(tui_p, row, cursor_col, col, color))
+                Frame_Printf(&tui_p->frame, ANSI_ESC "[%d;%dH", row + 1, col + 1);
+
+            // Set the color of the cell. (a space looks the same in every color)
+            if (cell.color != color && cell.ch != ' ')
+            {
+                color = cell.color;
+                Frame_Printf(&tui_p->frame, ANSI_ESC "[%dm", ANSI_COLOR_CODES[color]);
+            }
+
+            Frame_Put_Char(&tui_p->frame, cell.ch);
+            tui_p->shown_cells[cell_i] = cell;
+            cursor_row = row;
+            cursor_col = col + 1;
+        }
+    }
+
+    // Go back to the lines of the questions with the default color, and clear them.
+    Frame_Printf(&tui_p->frame, ANSI_ESC "[0m" ANSI_ESC "[%d;1H" ANSI_ESC "[J", tui_p->nof_rows + 1);
+    Frame_Flush(&tui_p->frame);
+}
+
+
+/*
+ * Write again the unchanged cells between the cursor and the next changed cell, instead of moving the cursor.
+ * Writes the cells only if the gap is shorter than a cursor move, and every cell in it is a space or has the current color.
+ * Receives a pointer to the TUI, the row, the collum of the cursor, the collum of the next changed cell and the current color.
+ * Returns true if the gap was written (the cursor is at the changed cell), false otherwise.
+ */
+bool Tui_Rewrite_Gap(TUI* tui_p, int row, int cursor_col, int col, int color)
+{
+    const SCREEN_CELL* row_cells = &tui_p->shown_cells[row * tui_p->nof_cols]; // The cells of the row on the screen.
+
+    if (col - cursor_col > TUI_MAX_REWRITE_GAP)
+        return false;
+
+    // Check that the cells look the same in the current color.
+    for (int gap_col = cursor_col; gap_col < col; gap_col++)
+        if (row_cells[gap_col].ch != ' ' && row_cells[gap_col].color != color)
+            return false;
+
+    for (int gap_col = cursor_col; gap_col < col; gap_col++)
+        Frame_Put_Char(&tui_p->frame, row_cells[gap_col].ch);
+
+    return true;
+}